@@ -0,0 +1,33 @@
+#ifndef __ASM_APIC_H
+#define __ASM_APIC_H
+
+#include <asm/apicdef.h>
+#include <asm/system.h>
+
+/*
+ * Basic functions accessing APICs. apic_base is where the local APIC
+ * is mapped, 0 if it isn't used. Every CPU sees its own APIC at the
+ * same address.
+ */
+extern unsigned long apic_base;
+
+static inline void apic_write(unsigned long reg, unsigned long v)
+{
+	*((volatile unsigned long *)(apic_base+reg)) = v;
+}
+
+static inline unsigned long apic_read(unsigned long reg)
+{
+	return *((volatile unsigned long *)(apic_base+reg));
+}
+
+static inline void ack_APIC_irq(void)
+{
+	/* Docs say use 0 for future compatibility */
+	apic_write(APIC_EOI, 0);
+}
+
+extern void setup_local_APIC(void);
+extern void setup_boot_APIC_clock(void);
+
+#endif /* __ASM_APIC_H */
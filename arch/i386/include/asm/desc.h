@@ -0,0 +1,28 @@
+#ifndef __ARCH_DESC_H
+#define __ARCH_DESC_H
+
+/*
+ * The interrupt descriptor table: 256 gates, filled in by trap_init()
+ * for the exceptions and by init_IRQ() for the 8259 interrupts.
+ */
+#define IDT_ENTRIES 256
+
+struct desc_struct {
+	unsigned long a,b;
+};
+
+extern struct desc_struct idt_table[];
+
+struct Xgt_desc_struct {
+	unsigned short size;
+	unsigned long address __attribute__((packed));
+};
+
+/* the IDT is shared, every CPU loads this */
+extern struct Xgt_desc_struct idt_descr;
+
+extern void set_intr_gate(unsigned int n, void *addr);
+extern void set_trap_gate(unsigned int n, void *addr);
+extern void set_system_gate(unsigned int n, void *addr);
+
+#endif
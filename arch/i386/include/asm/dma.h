@@ -0,0 +1,13 @@
+/*
+ * linux/include/asm/dma.h: Defines for using and allocating dma channels.
+ */
+#ifndef _ASM_DMA_H
+#define _ASM_DMA_H
+
+#include <asm/page.h>
+
+/* The maximum address that we can perform a DMA transfer to on this platform */
+// ISA DMA 只能访问物理内存的前 16MB，这里给出的是对应的内核虚拟地址
+#define MAX_DMA_ADDRESS      (PAGE_OFFSET+0x1000000)
+
+#endif /* _ASM_DMA_H */
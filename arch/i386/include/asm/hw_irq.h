@@ -0,0 +1,50 @@
+#ifndef _ASM_HW_IRQ_H
+#define _ASM_HW_IRQ_H
+
+/*
+ *	linux/include/asm/hw_irq.h
+ *
+ *	(C) 1992, 1993 Linus Torvalds, (C) 1997 Ingo Molnar
+ *
+ *	moved some of the old arch/i386/kernel/irq.h to here. VY
+ *
+ *	IRQ/IPI changes taken from work by Thomas Radke
+ *	<tomsoft@informatik.tu-chemnitz.de>
+ */
+
+#include <linux/linkage.h>
+#include <asm/irq.h>
+
+/*
+ * IDT vectors usable for external interrupt sources start
+ * at 0x20: the 8259s are remapped there, away from the exceptions.
+ */
+#define FIRST_EXTERNAL_VECTOR	0x20
+
+/*
+ * The local APIC's own interrupts sit at the top, above everything the
+ * 8259s can raise. The spurious vector's low 4 bits must be 1111.
+ */
+#define SPURIOUS_APIC_VECTOR	0xff
+#define INVALIDATE_TLB_VECTOR	0xfd
+#define CALL_FUNCTION_VECTOR	0xfb
+#define LOCAL_TIMER_VECTOR	0xef
+
+/* the entry stubs from entry.S, one per IRQ */
+extern void (*interrupt[NR_IRQS])(void);
+
+extern fastcall void do_IRQ(int irq);
+
+/* entry.S stubs for the local APIC vectors */
+extern void apic_timer_interrupt(void);
+extern void spurious_interrupt(void);
+extern void invalidate_interrupt(void);
+extern void call_function_interrupt(void);
+
+extern void init_8259A(void);
+extern void enable_8259A_irq(unsigned int irq);
+extern void disable_8259A_irq(unsigned int irq);
+extern int i8259A_irq_spurious(unsigned int irq);
+extern void i8259A_eoi(unsigned int irq);
+
+#endif /* _ASM_HW_IRQ_H */
@@ -16,6 +16,25 @@ static inline unsigned long virt_to_phys(volatile void *address) {
 #define __SLOW_DOWN_IO "\noutb %%al,$0x80"
 #endif
 
+extern void * __ioremap(unsigned long offset, unsigned long size, unsigned long flags);
+
+static inline void * ioremap (unsigned long offset, unsigned long size)
+{
+	return __ioremap(offset, size, 0);
+}
+
+/*
+ * This one maps high address device memory and turns off caching for that area.
+ * it's useful if some control registers are in such an area and write combining
+ * or read caching is not desirable:
+ */
+static inline void * ioremap_nocache (unsigned long offset, unsigned long size)
+{
+        return __ioremap(offset, size, PAGE_PCD | PAGE_PWT);
+}
+
+extern void iounmap(void *addr);
+
 #define virt_to_bus virt_to_phys
 #define bus_to_virt phys_to_virt
 
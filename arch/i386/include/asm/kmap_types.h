@@ -0,0 +1,18 @@
+#ifndef _ASM_KMAP_TYPES_H
+#define _ASM_KMAP_TYPES_H
+
+/*
+ * Each CPU has one kmap_atomic() slot per type, so a mapping taken in
+ * process context cannot be overwritten by an interrupt that kmaps on
+ * the same CPU: interrupt handlers use the KM_IRQ* types.
+ */
+enum km_type {
+	KM_BOUNCE_READ,
+	KM_USER0,
+	KM_USER1,
+	KM_IRQ0,
+	KM_IRQ1,
+	KM_TYPE_NR
+};
+
+#endif
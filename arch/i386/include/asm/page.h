@@ -6,7 +6,14 @@
 #define PAGE_SIZE (1UL << PAGE_SHIFT)
 #define PAGE_MASK (~(PAGE_SIZE - 1))
 
-#define clear_page(page) memset((void *)(page), 0, PAGE_SIZE)
+/* to align the pointer to the (next) page boundary */
+#define PAGE_ALIGN(addr) (((addr) + PAGE_SIZE - 1) & PAGE_MASK)
+
+/* rep stosl or SSE2 movnti, see arch/i386/lib/page.c */
+extern void (*__clear_page)(void *page);
+extern void clear_page_init(void);
+
+#define clear_page(page) __clear_page((void *)(page))
 #define copy_page(to, from) memcpy((void *)(to), (void *)(from), PAGE_SIZE)
 
 /*
@@ -42,6 +49,14 @@
  * 页目录项中的R/W位对其所映射的所有页面起作用。
  */
 #define PAGE_WRITE 0x2
+// PWT/PCD--位3、4控制页面的缓存方式，映射设备内存时置 PCD 禁止缓存
+#define PAGE_PWT 0x8
+#define PAGE_PCD 0x10
+// PS--页目录项的位7，置位时该项直接映射一个 4MB 的页面（需要 CR4.PSE），
+// PAE 下是页中间目录项映射一个 2MB 的页面
+#define PAGE_PSE 0x80
+// G--位8，全局页面，重新加载 CR3 时不会被刷出 TLB（需要 CR4.PGE）
+#define PAGE_GLOBAL 0x100
 
 // 对于系统空间而言，给定一个虚地址 x，其物理地址是 x - PAGE_OFFSET；相应地，给
 // 定一个物理地址 x，其虚拟地址是 x + PAGE_OFFSET。
@@ -66,6 +81,22 @@
   ((unsigned long)(-PAGE_OFFSET - VMALLOC_RESERVE))  // 定义宏MAXMEM，表示系统允许的最大内存大小，转换为unsigned
                                                      // long类
 
+/*
+ * These are used to make use of C type-checking..
+ */
+#ifdef CONFIG_X86_PAE
+// PAE 下页表项为 64 位，物理地址最多 36 位（64GB）
+typedef struct {
+  unsigned long pte_low, pte_high;
+} pte_t;
+typedef struct {
+  unsigned long long pmd;
+} pmd_t;
+typedef struct {
+  unsigned long long pgd;
+} pgd_t;
+#define pte_val(x) ((x).pte_low | ((unsigned long long)(x).pte_high << 32))
+#else
 typedef struct {
   unsigned long pte_low;
 } pte_t;  // 表示页表项（Page Table Entry）
@@ -75,10 +106,11 @@ typedef struct {
 typedef struct {
   unsigned long pgd;
 } pgd_t;  // 表示页全局目录项（Page Global Directory Entry）s
+#define pte_val(x) ((x).pte_low)  // 获取pte_t结构体中的pte_low成员的值
+#endif
 typedef struct {
   unsigned long pgprot;
 } pgprot_t;  // 定义结构体pgprot_t，表示页保护位（Page Protection Bits）
-#define pte_val(x) ((x).pte_low)  // 获取pte_t结构体中的pte_low成员的值
 #define pmd_val(x) ((x).pmd)      // 获取pmd_t结构体中的pmd成员的值
 #define pgd_val(x) ((x).pgd)
 #define pgprot_val(x) ((x).pgprot)
@@ -88,12 +120,21 @@ typedef struct {
 #define __pmd(x) ((pmd_t){(x)})  // 用于创建一个pgd_t结构体并初始化pgd成员为x
 #define __pgd(x) ((pgd_t){(x)})
 #define __pgprot(x) ((pgprot_t){(x)})
+#define virt_to_page(kaddr) \
+  pfn_to_page(__pa(kaddr) >> PAGE_SHIFT)  // 用于将给定的虚拟地址转换为对应的页结构体指针，通过将虚拟地址的物理地址部分右移PAGE_SHIFT位得到页帧号，再找到对应的页结构体
+
+#ifndef CONFIG_SPARSEMEM
 #define VALID_PAGE(page) \
   ((page - mem_map) <    \
    max_mapnr)  // 用于判断给定的页是否在有效的页范围内，即判断页是否位于mem_map和max_mapnr之间
-#define virt_to_page(kaddr) \
-  (mem_map +                \
-   (__pa(kaddr) >>          \
-    PAGE_SHIFT))  // 用于将给定的虚拟地址转换为对应的页结构体指针，通过将虚拟地址的物理地址部分右移PAGE_SHIFT位来计算页索引，再加上mem_map的起始地址来得到页结构体指针
+
+// 页帧号与 struct page 之间的转换，mem_map 从物理页 0 开始
+#define pfn_to_page(pfn) (mem_map + (pfn))
+#define page_to_pfn(page) ((unsigned long)((page) - mem_map))
+#define pfn_valid(pfn) ((pfn) < max_mapnr)
+#else
+// CONFIG_SPARSEMEM 下经由内存段表转换，见 linux/mm.h
+#define VALID_PAGE(page) pfn_valid(page_to_pfn(page))
+#endif
 
 #endif /* _I386_PAGE_H */
@@ -0,0 +1,43 @@
+/*
+ *  Per-processor Data Areas
+ *  Jeremy Fitzhardinge <jeremy@goop.org> 2006
+ *  Based on asm-x86_64/pda.h by Andi Kleen.
+ *
+ *  Each CPU's GDT has a data segment over its own struct i386_pda,
+ *  loaded in %fs, so per-CPU data is one %fs-relative load away
+ *  without knowing which CPU we are on.
+ */
+
+#ifndef _I386_PDA_H
+#define _I386_PDA_H
+
+#include <linux/threads.h>
+
+struct i386_pda
+{
+	struct i386_pda *_pda;		/* pointer to self */
+
+	int cpu_number;
+	int apicid;			/* the local APIC's ID */
+};
+
+extern struct i386_pda cpu_pda[NR_CPUS];
+
+#define pda_offset(field) __builtin_offsetof(struct i386_pda, field)
+
+/*
+ * Only 32-bit fields so far. Not volatile: a CPU's PDA never changes
+ * under it, the compiler may reuse what it read.
+ */
+#define read_pda(field) ({						\
+	typeof(((struct i386_pda *)0)->field) ret__;			\
+	__asm__ ("movl %%fs:%c1,%0"					\
+		 : "=r" (ret__) : "i" (pda_offset(field)));		\
+	ret__; })
+
+#define write_pda(field, val)						\
+	__asm__ __volatile__ ("movl %0,%%fs:%c1"			\
+			      : : "ri" (val), "i" (pda_offset(field))	\
+			      : "memory")
+
+#endif	/* _I386_PDA_H */
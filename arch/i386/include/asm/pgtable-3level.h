@@ -0,0 +1,90 @@
+#ifndef _I386_PGTABLE_3LEVEL_H
+#define _I386_PGTABLE_3LEVEL_H
+
+/*
+ * Intel Physical Address Extension (PAE) Mode - three-level page
+ * tables on PPro+ CPUs.
+ *
+ * Copyright (C) 1999 Ingo Molnar <mingo@redhat.com>
+ */
+
+/*
+ * PGDIR_SHIFT determines what a top-level page table entry can map
+ */
+#define PGDIR_SHIFT	30		// 一个页目录指针项映射 1GB
+#define PTRS_PER_PGD	4
+
+/*
+ * PMD_SHIFT determines the size of the area a middle-level
+ * page table can map
+ */
+#define PMD_SHIFT	21		// 一个页中间目录项映射 2MB
+#define PTRS_PER_PMD	512
+
+/*
+ * entries per page directory level
+ */
+#define PTRS_PER_PTE	512
+
+/*
+ * The four pgd entries are loaded into the CPU's PDPTE registers
+ * when CR3 is written; only the present and cache bits are allowed
+ * in them, so the pmd page is always linked with just PAGE_PRESENT.
+ */
+#define pgd_none(x)	(!pgd_val(x))
+#define pgd_present(x)	(pgd_val(x) & PAGE_PRESENT)
+#define pgd_clear(xp)	do { set_pgd(xp, __pgd(0ULL)); } while (0)
+
+/*
+ * An entry is only looked at by the MMU once its present bit, in
+ * the low word, is set: write the high word first when installing
+ * and clear the low word first when tearing down, so it never sees
+ * half of an entry.
+ */
+static inline void set_pte(pte_t *ptep, pte_t pte)
+{
+	ptep->pte_high = pte.pte_high;
+	barrier();
+	ptep->pte_low = pte.pte_low;
+}
+
+static inline void set_64bit(unsigned long long *ptr, unsigned long long val)
+{
+	unsigned long *p = (unsigned long *) ptr;
+
+	p[1] = (unsigned long) (val >> 32);
+	barrier();
+	p[0] = (unsigned long) val;
+}
+
+#define set_pmd(pmdptr, pmdval) set_64bit(&(pmdptr)->pmd, pmd_val(pmdval))
+#define set_pgd(pgdptr, pgdval) set_64bit(&(pgdptr)->pgd, pgd_val(pgdval))
+
+static inline void pte_clear(pte_t *ptep)
+{
+	ptep->pte_low = 0;
+	barrier();
+	ptep->pte_high = 0;
+}
+
+#define pgd_page(pgd) \
+	((unsigned long) __va(pgd_val(pgd) & PAGE_MASK))
+
+/* Find an entry in the second-level page table.. */
+#define pmd_offset(dir, address) ((pmd_t *) pgd_page(*(dir)) + \
+			__pmd_offset(address))
+
+#define pte_none(x)	(!(x).pte_low && !(x).pte_high)
+#define pte_page(x)	pfn_to_page(((x).pte_low >> PAGE_SHIFT) | \
+			((x).pte_high << (32 - PAGE_SHIFT)))
+
+static inline pte_t __mk_pte(unsigned long page_nr, pgprot_t pgprot)
+{
+	pte_t pte;
+
+	pte.pte_high = page_nr >> (32 - PAGE_SHIFT);
+	pte.pte_low = (page_nr << PAGE_SHIFT) | pgprot_val(pgprot);
+	return pte;
+}
+
+#endif /* _I386_PGTABLE_3LEVEL_H */
@@ -1,7 +1,144 @@
 #ifndef _I386_PGTABLE_H
 #define _I386_PGTABLE_H
 
+#include <asm/page.h>
+#include <asm/processor.h>
+
+#ifdef CONFIG_X86_PAE
+# include <asm/pgtable-3level.h>
+#else
+# include <asm/pgtable-2level.h>
+#endif
+
+#define PMD_SIZE	(1UL << PMD_SHIFT)
+#define PMD_MASK	(~(PMD_SIZE-1))
+#define PGDIR_SIZE	(1UL << PGDIR_SHIFT)
+#define PGDIR_MASK	(~(PGDIR_SIZE-1))
+
+#define __pgd_offset(address) (((address) >> PGDIR_SHIFT) & (PTRS_PER_PGD-1))
+#define __pmd_offset(address) (((address) >> PMD_SHIFT) & (PTRS_PER_PMD-1))
+#define __pte_offset(address) (((address) >> PAGE_SHIFT) & (PTRS_PER_PTE-1))
+
+extern pgd_t swapper_pg_dir[PTRS_PER_PGD];	// paging_init() 建立的内核页目录
+
+/* to find an entry in the kernel page-table-directory */
+#define pgd_offset_k(address) (swapper_pg_dir + __pgd_offset(address))
+
+#define pmd_none(x)	(!pmd_val(x))
+#define pmd_present(x)	(pmd_val(x) & PAGE_PRESENT)
+#define pmd_clear(xp)	do { set_pmd(xp, __pmd(0)); } while (0)
+// 页中间目录项指向的页表（两级页表下就是页目录项）
+#define pmd_page(pmd) \
+	((unsigned long) __va(pmd_val(pmd) & PAGE_MASK))
+#define pte_offset(dir, address) ((pte_t *) pmd_page(*(dir)) + \
+			__pte_offset(address))
+
+#define pte_present(x)	((x).pte_low & PAGE_PRESENT)
+
+/*
+ * Kernel mappings are global once paging_init() has turned on PGE.
+ */
+extern unsigned long __PAGE_KERNEL;
+#define PAGE_KERNEL		__pgprot(__PAGE_KERNEL)
+#define PAGE_KERNEL_NOCACHE	__pgprot(__PAGE_KERNEL | PAGE_PCD)
+
+#define mk_pte(page, pgprot)	__mk_pte(page_to_pfn(page), (pgprot))
+#define mk_pte_phys(physpage, pgprot)	__mk_pte((physpage) >> PAGE_SHIFT, (pgprot))
+
+/*
+ * Just any arbitrary offset to the start of the vmalloc VM area: the
+ * current 8MB value just means that there will be a 8MB "hole" after the
+ * physical memory until the kernel virtual memory starts.  That means that
+ * any out-of-bounds memory accesses will hopefully be caught.
+ * The vmalloc() routines leaves a hole of 4kB between each vmalloced
+ * area for the same reason. ;)
+ *
+ * The top 32MB of the address space are kept for the kmap() pool at
+ * PKMAP_BASE and the fixed mappings (asm/highmem.h, asm/fixmap.h).
+ */
+#define VMALLOC_OFFSET	(8*1024*1024)
+#define VMALLOC_START	(((unsigned long) high_memory + 2*VMALLOC_OFFSET-1) & \
+						~(VMALLOC_OFFSET-1))
+#define VMALLOC_END	(0xFE000000UL - 2*PAGE_SIZE)
+
+extern pte_t *pte_alloc_kernel(pmd_t *pmd, unsigned long address);
+
+#define __flush_tlb()							\
+	do {								\
+		unsigned int tmpreg;					\
+									\
+		__asm__ __volatile__(					\
+			"movl %%cr3, %0;  # flush TLB \\n"		\
+			"movl %0, %%cr3;              \\n"		\
+			: "=r" (tmpreg)					\
+			:: "memory");					\
+	} while (0)
+
+/*
+ * Global pages have to be flushed a bit differently. Not a real
+ * performance problem because this does not happen often.
+ */
+#define __flush_tlb_global()						\
+	do {								\
+		unsigned int tmpreg;					\
+									\
+		__asm__ __volatile__(					\
+			"movl %1, %%cr4;  # turn off PGE     \n"	\
+			"movl %%cr3, %0;  # flush TLB        \n"	\
+			"movl %0, %%cr3;                     \n"	\
+			"movl %2, %%cr4;  # turn PGE back on \n"	\
+			: "=&r" (tmpreg)				\
+			: "r" (mmu_cr4_features & ~X86_CR4_PGE),	\
+			  "r" (mmu_cr4_features)			\
+			: "memory");					\
+	} while (0)
+
+#define __flush_tlb_all()						\
+	do {								\
+		if (cpu_has_pge)					\
+			__flush_tlb_global();				\
+		else							\
+			__flush_tlb();					\
+	} while (0)
+
+#define load_cr3(pgdir) \
+	__asm__ __volatile__("movl %0,%%cr3": :"r" (__pa(pgdir)))
+
+#define __flush_tlb_one(addr) \
+	__asm__ __volatile__("invlpg %0": :"m" (*(char *) addr))
+
+/*
+ * Flushing a few pages one by one is cheaper than refilling the whole
+ * TLB afterwards.
+ */
+#define FLUSH_TLB_SINGLE_MAX	32
+
+/* this CPU only */
+static inline void __flush_tlb_kernel_range(unsigned long start, unsigned long end)
+{
+	if ((end - start) >> PAGE_SHIFT > FLUSH_TLB_SINGLE_MAX) {
+		__flush_tlb_all();
+		return;
+	}
+	for (; start < end; start += PAGE_SIZE)
+		__flush_tlb_one(start);
+}
+
+/*
+ * Kernel mappings are shared by every CPU: on SMP the others are told
+ * to flush with an IPI (arch/i386/kernel/smp.c).
+ */
+#ifdef CONFIG_SMP
+extern void flush_tlb_all(void);
+extern void flush_tlb_kernel_range(unsigned long start, unsigned long end);
+#else
+#define flush_tlb_all()			__flush_tlb_all()
+#define flush_tlb_kernel_range(start, end) \
+	__flush_tlb_kernel_range(start, end)
+#endif
+
 #define pages_to_mb(x) ((x) >> (20-PAGE_SHIFT))
 extern void paging_init(void);
+extern void zap_low_mappings(void);
 
-#endif
\ No newline at end of file
+#endif
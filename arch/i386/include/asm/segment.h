@@ -0,0 +1,21 @@
+#ifndef _ASM_SEGMENT_H
+#define _ASM_SEGMENT_H
+
+/*
+ * The kernel's flat segments, same as SELECTOR_K_CODE/SELECTOR_K_DATA
+ * in gdt.h, but without the C around them so entry.S can use them.
+ */
+#define __KERNEL_CS	0x08
+#define __KERNEL_DS	0x10
+
+/*
+ * Entries 0-5 are the boot GDT of boot.c, 6 is kept for the TSS. On
+ * SMP every CPU has its own copy of the table, with one more entry:
+ * a data segment over the CPU's struct i386_pda, loaded in %fs.
+ */
+#define GDT_ENTRY_KERNEL_PDA	7
+#define __KERNEL_PDA	(GDT_ENTRY_KERNEL_PDA * 8)
+
+#define GDT_ENTRIES	8
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef __ASM_SMP_H
+#define __ASM_SMP_H
+
+/*
+ * The APs start in real mode at TRAMPOLINE_BASE, the page setup_memory()
+ * reserves for them. The STARTUP IPI's vector is its page number.
+ */
+#define TRAMPOLINE_BASE		0x1000
+
+#ifndef __ASSEMBLER__
+
+#include <linux/threads.h>
+
+#ifdef CONFIG_SMP
+#include <asm/apic.h>
+#include <asm/pda.h>
+
+extern int smp_num_cpus;
+extern volatile unsigned long cpu_online_map;
+extern int x86_cpu_to_apicid[NR_CPUS];
+
+/*
+ * CPUs are numbered in the order they came up, the boot CPU is 0.
+ */
+#define cpu_logical_map(cpu)	(cpu)
+#define cpu_number_map(cpu)	(cpu)
+
+#define smp_processor_id()	read_pda(cpu_number)
+#define hard_smp_processor_id()	GET_APIC_ID(apic_read(APIC_ID))
+
+extern void smp_prepare_boot_cpu(void);
+extern void smp_boot_cpus(void);
+extern void smp_intr_init(void);
+extern int smp_call_function(void (*func) (void *info), void *info, int wait);
+
+#endif /* CONFIG_SMP */
+
+#endif /* !__ASSEMBLER__ */
+
+#endif /* __ASM_SMP_H */
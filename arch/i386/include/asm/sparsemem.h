@@ -0,0 +1,25 @@
+/*
+ * include/asm-i386/sparsemem.h
+ */
+#ifndef _I386_SPARSEMEM_H
+#define _I386_SPARSEMEM_H
+#ifdef CONFIG_SPARSEMEM
+
+/*
+ * generic non-linear memory support:
+ *
+ * 1) we will not split memory into more chunks than will fit into the
+ *    flags field of the struct page
+ *
+ * SECTION_SIZE_BITS		2^N: how big each section will be
+ * MAX_PHYSMEM_BITS		2^N: how much memory we can have in that space
+ */
+#define SECTION_SIZE_BITS	26	// 每个内存段 64MB
+#ifdef CONFIG_X86_PAE
+#define MAX_PHYSMEM_BITS	36	// PAE 页表项可以表示 64GB 物理地址
+#else
+#define MAX_PHYSMEM_BITS	32
+#endif
+
+#endif /* CONFIG_SPARSEMEM */
+#endif /* _I386_SPARSEMEM_H */
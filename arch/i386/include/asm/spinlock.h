@@ -0,0 +1,331 @@
+#ifndef __ASM_SPINLOCK_H
+#define __ASM_SPINLOCK_H
+
+#include <asm/atomic.h>
+#include <asm/processor.h>
+#include <asm/system.h>
+#include <linux/threads.h>
+
+#ifdef LOCK_STAT
+#include <linux/lockstat.h>
+#define LOCK_STAT_INIT		, LOCK_STAT_MAP_INIT
+#else
+#define LOCK_STAT_INIT
+#endif
+
+/*
+ * Two kinds of SMP spinlocks. Both are unlocked when all zero.
+ *
+ * spinlock_t is a ticket lock: a locked xadd draws the next ticket,
+ * and the lock is ours once "owner" gets to it. CPUs get the lock in
+ * the order they asked for it. A waiter knows how many are ahead of
+ * it and backs off with PAUSE in proportion, so the lock's cache line
+ * is read less often the longer the queue is. That is the lock for
+ * short critical sections.
+ *
+ * qspinlock_t is a queued (MCS) lock, for the heavily contended ones
+ * such as zone->lock. Waiters queue up behind each other and each
+ * spins on its own per-CPU node. Only the head of the queue watches
+ * the lock word, so a hand-over moves one cache line between two CPUs
+ * instead of all of them. Taking a free lock is one cmpxchg.
+ *
+ * spin_lock() and friends take either. The type of the lock picks the
+ * implementation at compile time, so the irqsave/bh variants in
+ * linux/spinlock.h work on both.
+ *
+ * With lock statistics (LOCK_STAT, see linux/lockstat.h) each lock
+ * also carries the class it is counted in, and every acquisition
+ * tries the lock once first: if that fails, it was contended and the
+ * wait is timed.
+ */
+
+#if NR_CPUS >= 256
+#error "the ticket lock has 8-bit tickets, NR_CPUS must be below 256"
+#endif
+
+typedef struct {
+	union {
+		volatile unsigned short slock;
+		struct {
+			volatile unsigned char owner;	/* the ticket being served */
+			volatile unsigned char next;	/* the next ticket handed out */
+		} tickets;
+	};
+#ifdef LOCK_STAT
+	struct lock_stat_map map;
+#endif
+} spinlock_t;
+
+/* the bare initializer, for locks inside other locks' initializers */
+#define __SPIN_LOCK_UNLOCKED	{ { 0 } LOCK_STAT_INIT }
+#define SPIN_LOCK_UNLOCKED (spinlock_t) __SPIN_LOCK_UNLOCKED
+
+/* PAUSEs per waiter ahead of us, about one short critical section */
+#define TICKET_BACKOFF		16
+
+static inline void __ticket_spin_lock(spinlock_t *lock)
+{
+	unsigned short inc = 0x0100;
+	unsigned char ticket;
+
+	__asm__ __volatile__(
+		"lock ; xaddw %w0,%1"
+		: "+q" (inc), "+m" (lock->slock) : : "memory");
+	ticket = inc >> 8;
+	if (ticket == (unsigned char) inc)
+		return;
+
+	for (;;) {
+		unsigned char ahead = ticket - lock->tickets.owner;
+		unsigned int loops;
+
+		if (!ahead)
+			break;
+		// 前面每多一个等待者就多退避一段，少去读锁所在的缓存行
+		loops = ahead * TICKET_BACKOFF;
+		while (loops--)
+			rep_nop();
+	}
+	barrier();
+}
+
+static inline int __ticket_spin_trylock(spinlock_t *lock)
+{
+	unsigned short old = lock->slock;
+
+	if ((old >> 8) != (old & 0xff))
+		return 0;
+	return cmpxchg(&lock->slock, old, old + 0x0100) == old;
+}
+
+/*
+ * Only the owner writes ->owner, a plain increment is enough.
+ */
+static inline void __ticket_spin_unlock(spinlock_t *lock)
+{
+	__asm__ __volatile__(
+		"incb %0"
+		: "+m" (lock->tickets.owner) : : "memory");
+}
+
+static inline void __ticket_spin_init(spinlock_t *lock)
+{
+	lock->slock = 0;
+}
+
+static inline int __ticket_spin_is_locked(spinlock_t *lock)
+{
+	unsigned short tmp = lock->slock;
+
+	return (tmp >> 8) != (tmp & 0xff);
+}
+
+/*
+ * The queued lock's word: the locked byte at the bottom, the queue's
+ * tail in the upper half, (cpu + 1) << 2 | nesting level of the tail
+ * waiter's node, so 0 means nobody is queued.
+ */
+typedef struct {
+	volatile unsigned int val;
+#ifdef LOCK_STAT
+	struct lock_stat_map map;
+#endif
+} qspinlock_t;
+
+#define QSPIN_LOCK_UNLOCKED (qspinlock_t) { 0 LOCK_STAT_INIT }
+
+#define _Q_LOCKED_VAL		1U
+#define _Q_LOCKED_MASK		0xffU
+#define _Q_TAIL_OFFSET		16
+#define _Q_TAIL_MASK		0xffff0000U
+
+extern void queued_spin_lock_slowpath(qspinlock_t *lock);
+
+static inline void queued_spin_lock(qspinlock_t *lock)
+{
+	if (cmpxchg(&lock->val, 0, _Q_LOCKED_VAL) == 0)
+		return;
+	queued_spin_lock_slowpath(lock);
+}
+
+/*
+ * Nobody but a free, unqueued lock's taker sets the locked byte, so
+ * it can be taken only when the whole word is 0.
+ */
+static inline int queued_spin_trylock(qspinlock_t *lock)
+{
+	return !lock->val && cmpxchg(&lock->val, 0, _Q_LOCKED_VAL) == 0;
+}
+
+static inline void queued_spin_unlock(qspinlock_t *lock)
+{
+	__asm__ __volatile__(
+		"movb $0,%0"
+		: "=m" (*(volatile unsigned char *)&lock->val) : : "memory");
+}
+
+static inline void queued_spin_init(qspinlock_t *lock)
+{
+	lock->val = 0;
+}
+
+static inline int queued_spin_is_locked(qspinlock_t *lock)
+{
+	return lock->val & _Q_LOCKED_MASK;
+}
+
+#define __spin_is_queued(lock) \
+	__builtin_types_compatible_p(typeof(*(lock)), qspinlock_t)
+
+#define __spin_op(op, lock)						\
+	__builtin_choose_expr(__spin_is_queued(lock),			\
+		queued_spin_##op((qspinlock_t *)(lock)),		\
+		__ticket_spin_##op((spinlock_t *)(lock)))
+
+#ifdef LOCK_STAT
+
+#define BUILD_LOCK_STAT_OPS(op, locktype)				\
+static inline void op##lock_stat(locktype *lock)			\
+{									\
+	cycles_t wait;							\
+									\
+	if (op##trylock(lock)) {					\
+		lock_stat_acquired(&lock->map, 0, 0);			\
+		return;							\
+	}								\
+	wait = lock_stat_clock();					\
+	op##lock(lock);							\
+	lock_stat_acquired(&lock->map, 1, lock_stat_clock() - wait);	\
+}									\
+									\
+static inline int op##trylock_stat(locktype *lock)			\
+{									\
+	if (!op##trylock(lock))						\
+		return 0;						\
+	lock_stat_acquired(&lock->map, 0, 0);				\
+	return 1;							\
+}									\
+									\
+static inline void op##unlock_stat(locktype *lock)			\
+{									\
+	lock_stat_release(&lock->map);					\
+	op##unlock(lock);						\
+}
+
+BUILD_LOCK_STAT_OPS(__ticket_spin_, spinlock_t)
+BUILD_LOCK_STAT_OPS(queued_spin_, qspinlock_t)
+
+/* the class is keyed by where spin_lock_init() is called from */
+#define spin_lock_init(x)						\
+	do {								\
+		__spin_op(init, x);					\
+		lock_stat_map_init(&(x)->map);				\
+	} while (0)
+#define spin_lock(x)		__spin_op(lock_stat, x)
+#define spin_trylock(x)		__spin_op(trylock_stat, x)
+#define spin_unlock(x)		__spin_op(unlock_stat, x)
+
+#else
+
+#define spin_lock_init(x)	__spin_op(init, x)
+#define spin_lock(x)		__spin_op(lock, x)
+#define spin_trylock(x)		__spin_op(trylock, x)
+#define spin_unlock(x)		__spin_op(unlock, x)
+
+#endif /* LOCK_STAT */
+
+#define spin_is_locked(x)	__spin_op(is_locked, x)
+#define spin_unlock_wait(x)	do { barrier(); } while(spin_is_locked(x))
+
+/*
+ * Read-write spinlocks, allowing multiple readers
+ * but only one writer.
+ *
+ * NOTE! it is quite common to have readers in interrupts
+ * but no interrupt writers. For those circumstances we
+ * can "mix" irq-safe locks - any writer needs to get a
+ * irq-safe write-lock, but readers can get non-irqsafe
+ * read-locks.
+ *
+ * These are queued rwlocks: the low byte of cnts is the writer's,
+ * the readers are counted above it. A reader or writer that can't
+ * have the lock at once queues up on wait_lock, so they get it in the
+ * order they came, and a stream of readers can't starve a writer.
+ * The writer at the head of the queue sets _QW_WAITING, which keeps
+ * new readers out, and takes the lock once the readers left are gone.
+ *
+ * A reader with interrupts off may have interrupted a reader of the
+ * same lock on this CPU, and so must not queue behind a writer
+ * waiting for that one: it only waits for a writer holding the lock.
+ */
+typedef struct {
+	atomic_t cnts;
+	spinlock_t wait_lock;
+} rwlock_t;
+
+#define RW_LOCK_UNLOCKED (rwlock_t) { ATOMIC_INIT(0), __SPIN_LOCK_UNLOCKED }
+
+#define rwlock_init(x)	do { *(x) = RW_LOCK_UNLOCKED; } while(0)
+
+#define _QW_WAITING	0x01		/* A writer is waiting */
+#define _QW_LOCKED	0xff		/* A writer holds the lock */
+#define _QW_WMASK	0xff		/* Writer mask */
+#define _QR_SHIFT	8		/* Reader count shift */
+#define _QR_BIAS	(1U << _QR_SHIFT)
+
+extern void queued_read_lock_slowpath(rwlock_t *lock, unsigned int cnts);
+extern void queued_write_lock_slowpath(rwlock_t *lock);
+
+static inline void read_lock(rwlock_t *lock)
+{
+	unsigned int cnts;
+
+	cnts = atomic_add_return(_QR_BIAS, &lock->cnts);
+	if (!(cnts & _QW_WMASK))
+		return;
+	queued_read_lock_slowpath(lock, cnts);
+}
+
+static inline int read_trylock(rwlock_t *lock)
+{
+	unsigned int cnts;
+
+	if (atomic_read(&lock->cnts) & _QW_WMASK)
+		return 0;
+	cnts = atomic_add_return(_QR_BIAS, &lock->cnts);
+	if (!(cnts & _QW_WMASK))
+		return 1;
+	atomic_sub(_QR_BIAS, &lock->cnts);
+	return 0;
+}
+
+static inline void read_unlock(rwlock_t *lock)
+{
+	atomic_sub(_QR_BIAS, &lock->cnts);
+}
+
+static inline void write_lock(rwlock_t *lock)
+{
+	if (cmpxchg(&lock->cnts.counter, 0, _QW_LOCKED) == 0)
+		return;
+	queued_write_lock_slowpath(lock);
+}
+
+static inline int write_trylock(rwlock_t *lock)
+{
+	return !atomic_read(&lock->cnts) &&
+		cmpxchg(&lock->cnts.counter, 0, _QW_LOCKED) == 0;
+}
+
+/*
+ * Only the writer writes the writer byte while it holds the lock.
+ */
+static inline void write_unlock(rwlock_t *lock)
+{
+	__asm__ __volatile__(
+		"movb $0,%0"
+		: "=m" (*(volatile unsigned char *)&lock->cnts.counter)
+		: : "memory");
+}
+
+#endif /* __ASM_SPINLOCK_H */
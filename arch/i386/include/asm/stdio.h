@@ -7,12 +7,16 @@ typedef char* va_list;
 
 extern int sprintf(char* buf, const char* fmt, ...);
 extern int vsprintf(char* buf, const char* fmt, va_list args);
+extern int snprintf(char* buf, size_t size, const char* fmt, ...);
+extern int vsnprintf(char* buf, size_t size, const char* fmt, va_list args);
 extern char* itoa(int num, char* dst, int radix);
 extern char* uitoa(unsigned int num, char* dst, int radix);
 extern void print_int(int num);
 extern void print_hex(unsigned int num);
 extern void put_char(char ch);
 extern void printk(const char* format, ...);
+/* 只写进日志缓冲区，不输出到控制台（留给持有控制台锁的人或空闲循环） */
+extern void printk_deferred(const char* format, ...);
 extern void print_str(char* str);
 
 #define va_start(ap, v) ap = (va_list) & v + sizeof(v)
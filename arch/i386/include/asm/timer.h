@@ -0,0 +1,11 @@
+#ifndef _ASMi386_TIMER_H
+#define _ASMi386_TIMER_H
+
+extern void time_init(void);
+extern void tsc_init(void);
+
+/* PIT channel 2 as a stopwatch, for calibrating the TSC and APIC timer */
+extern void pit_calibrate_start(unsigned long ms);
+extern int pit_calibrate_done(void);
+
+#endif
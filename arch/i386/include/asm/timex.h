@@ -0,0 +1,29 @@
+/*
+ * linux/include/asm-i386/timex.h
+ *
+ * i386 architecture timex specifications
+ */
+#ifndef _ASMi386_TIMEX_H
+#define _ASMi386_TIMEX_H
+
+#include <asm/msr.h>
+
+#define CLOCK_TICK_RATE	1193182 /* Underlying HZ */
+
+/*
+ * Standard way to access the cycle counter on i586+ CPUs. Callers
+ * check cpu_has_tsc (or cpu_khz) first, a 486 has no rdtsc.
+ */
+typedef unsigned long long cycles_t;
+
+static inline cycles_t get_cycles (void)
+{
+	unsigned long long ret;
+
+	rdtscll(ret);
+	return ret;
+}
+
+extern unsigned long cpu_khz;
+
+#endif
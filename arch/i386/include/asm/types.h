@@ -50,6 +50,12 @@ typedef __kernel_size_t size_t;
 #endif
 typedef __kernel_clock_t clock_t;
 typedef uint32_t dma_addr_t;
+/* 物理地址类型，开启 PAE 后物理地址超过 32 位 */
+#ifdef CONFIG_X86_PAE
+typedef unsigned long long phys_addr_t;
+#else
+typedef unsigned long phys_addr_t;
+#endif
 typedef unsigned short umode_t;
 typedef __kernel_nlink_t nlink_t;
 typedef __kernel_uid32_t uid_t;
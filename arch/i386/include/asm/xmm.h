@@ -0,0 +1,52 @@
+#ifndef __ASM_XMM_H
+#define __ASM_XMM_H
+
+/*
+ * Kernel use of the SSE registers.
+ *
+ * Nothing saves %xmm0-%xmm7 on interrupt entry, and an interrupt
+ * handler may itself do a long memcpy/memset. So whoever loads an XMM
+ * register spills the ones it is about to clobber to its own stack
+ * with kernel_xmm_begin() and reloads them with kernel_xmm_end():
+ * an interrupted loop gets its registers back however deeply the
+ * interrupts nest. A few unaligned moves are cheaper than an FXSAVE
+ * of the whole 512-byte area, and the stack isn't 16-byte aligned in
+ * interrupt context anyway.
+ *
+ * The compiler never generates SSE code for the kernel (-m32 targets
+ * i686), so only these inline asm users have anything in there.
+ */
+
+struct xmm_save {
+	unsigned char reg[4][16];
+};
+
+#define __xmm_spill(n, s) \
+	__asm__ __volatile__("movdqu %%xmm" #n ",%0" : "=m" ((s)->reg[n]))
+#define __xmm_fill(n, s) \
+	__asm__ __volatile__("movdqu %0,%%xmm" #n : : "m" ((s)->reg[n]))
+
+/* Save %xmm0 .. %xmm(nr - 1), nr is at most 4 */
+static inline void kernel_xmm_begin(struct xmm_save *s, int nr)
+{
+	__xmm_spill(0, s);
+	if (nr > 1)
+		__xmm_spill(1, s);
+	if (nr > 2)
+		__xmm_spill(2, s);
+	if (nr > 3)
+		__xmm_spill(3, s);
+}
+
+static inline void kernel_xmm_end(struct xmm_save *s, int nr)
+{
+	__xmm_fill(0, s);
+	if (nr > 1)
+		__xmm_fill(1, s);
+	if (nr > 2)
+		__xmm_fill(2, s);
+	if (nr > 3)
+		__xmm_fill(3, s);
+}
+
+#endif /* __ASM_XMM_H */
@@ -0,0 +1,180 @@
+/*
+ *  arch/i386/kernel/acpi.c - Architecture-Specific Low-Level ACPI Boot Support
+ *
+ *  Copyright (C) 2001, 2002 Paul Diefenbaugh <paul.s.diefenbaugh@intel.com>
+ *  Copyright (C) 2001 Jun Nakajima <jun.nakajima@intel.com>
+ *
+ *  Just enough ACPI to find the processors in the MADT. The RSDP is
+ *  looked for early, below 1MB where everything is mapped; the tables
+ *  it leads to are usually at the top of RAM, outside the direct map,
+ *  and are only read once ioremap() works.
+ */
+
+#include <linux/acpi.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include <asm/io.h>
+#include <asm/mpspec.h>
+#include <asm/stdio.h>
+
+#ifdef CONFIG_X86_LOCAL_APIC
+
+/* physical address of the RSDP, 0 if there is none */
+static unsigned long acpi_rsdp;
+
+static u8 __init acpi_checksum(void *p, unsigned long len)
+{
+	u8 *b = p, sum = 0;
+
+	while (len--)
+		sum += *b++;
+	return sum;
+}
+
+/* The RSDP is on a 16-byte boundary, the ACPI 1.0 part sums to 0 */
+static unsigned long __init acpi_scan_rsdp(unsigned long start,
+					   unsigned long length)
+{
+	unsigned long offset;
+
+	for (offset = 0; offset < length; offset += 16) {
+		struct acpi_table_rsdp *rsdp = phys_to_virt(start + offset);
+
+		if (memcmp(rsdp->signature, ACPI_RSDP_SIG, 8))
+			continue;
+		if (acpi_checksum(rsdp, 20))
+			continue;
+		return start + offset;
+	}
+	return 0;
+}
+
+/*
+ * Look in the first 1K of the EBDA, then in the BIOS area from
+ * 0xE0000 to 1MB.
+ */
+int __init acpi_find_rsdp(void)
+{
+	unsigned long ebda = *(unsigned short *)phys_to_virt(0x40E) << 4;
+
+	if (ebda)
+		acpi_rsdp = acpi_scan_rsdp(ebda, 0x400);
+	if (!acpi_rsdp)
+		acpi_rsdp = acpi_scan_rsdp(0xE0000, 0x20000);
+	if (!acpi_rsdp)
+		return -1;
+
+	printk("ACPI: RSDP at 0x%08lx\n", acpi_rsdp);
+	return 0;
+}
+
+/* Map a whole table, the header tells how long it is */
+static struct acpi_table_header * __init acpi_map_table(unsigned long phys)
+{
+	struct acpi_table_header *header;
+	u32 length;
+
+	header = mp_map_table(phys, sizeof(*header));
+	if (!header)
+		return NULL;
+	length = header->length;
+	mp_unmap_table(header);
+	if (length < sizeof(*header))
+		return NULL;
+
+	header = mp_map_table(phys, length);
+	if (header && acpi_checksum(header, length)) {
+		printk(KERN_WARNING "ACPI: bad checksum, table at 0x%08lx"
+		       " ignored\n", phys);
+		mp_unmap_table(header);
+		return NULL;
+	}
+	return header;
+}
+
+static void __init acpi_parse_madt(struct acpi_table_madt *madt)
+{
+	struct acpi_table_entry_header *entry;
+	unsigned long end = (unsigned long)madt + madt->header.length;
+
+	mp_lapic_addr = madt->lapic_address;
+
+	entry = (struct acpi_table_entry_header *)(madt + 1);
+	while ((unsigned long)entry + sizeof(*entry) <= end) {
+		if (entry->length < sizeof(*entry) ||
+		    (unsigned long)entry + entry->length > end)
+			break;		/* the rest can't be trusted */
+
+		switch (entry->type) {
+		case ACPI_MADT_LAPIC:
+		{
+			struct acpi_table_lapic *p =
+				(struct acpi_table_lapic *)entry;
+
+			mp_register_lapic(p->id, p->flags.enabled);
+			break;
+		}
+		case ACPI_MADT_LAPIC_ADDR_OVR:
+		{
+			struct acpi_table_lapic_addr_ovr *p =
+				(struct acpi_table_lapic_addr_ovr *)entry;
+
+			// 超过 4GB 的地址映射不了，保持原来的
+			if (!(p->address >> 32))
+				mp_lapic_addr = (unsigned long)p->address;
+			break;
+		}
+		}
+		entry = (struct acpi_table_entry_header *)
+			((unsigned long)entry + entry->length);
+	}
+}
+
+/*
+ * Walk the RSDT for the MADT and register its local APICs. The XSDT
+ * of ACPI 2.0 lists the same tables with 64-bit addresses, which is
+ * no use to us, so it is never looked at. Returns 0 if processors
+ * were found.
+ */
+int __init acpi_boot_init(void)
+{
+	struct acpi_table_rsdp *rsdp;
+	struct acpi_table_rsdt *rsdt;
+	int i, count, found = 0;
+
+	if (!acpi_rsdp)
+		return -1;
+
+	rsdp = phys_to_virt(acpi_rsdp);
+	rsdt = (struct acpi_table_rsdt *)acpi_map_table(rsdp->rsdt_address);
+	if (!rsdt)
+		return -1;
+	if (memcmp(rsdt->header.signature, "RSDT", 4)) {
+		printk(KERN_WARNING "ACPI: no RSDT at 0x%08lx\n",
+		       (unsigned long)rsdp->rsdt_address);
+		mp_unmap_table(rsdt);
+		return -1;
+	}
+
+	count = (rsdt->header.length - sizeof(rsdt->header)) / sizeof(u32);
+	for (i = 0; i < count && !found; i++) {
+		struct acpi_table_header *header;
+
+		header = acpi_map_table(rsdt->entry[i]);
+		if (!header)
+			continue;
+		if (!memcmp(header->signature, ACPI_MADT_SIG, 4)) {
+			printk("ACPI: MADT at 0x%08lx\n",
+			       (unsigned long)rsdt->entry[i]);
+			acpi_parse_madt((struct acpi_table_madt *)header);
+			found = 1;
+		}
+		mp_unmap_table(header);
+	}
+	mp_unmap_table(rsdt);
+
+	return found && num_processors ? 0 : -1;
+}
+
+#endif /* CONFIG_X86_LOCAL_APIC */
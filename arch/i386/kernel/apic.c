@@ -0,0 +1,200 @@
+/*
+ *	Local APIC handling, local APIC timers
+ *
+ *	(c) 1999, 2000 Ingo Molnar <mingo@redhat.com>
+ *
+ *	Fixes
+ *	Maciej W. Rozycki	:	Bits for genuine 82489DX APICs;
+ *					thanks to Eric Gilmore
+ *					and Rolf G. Tews
+ *					for testing these extensively.
+ *
+ *	The boot CPU's APIC timer makes the tick, the other CPUs' APICs
+ *	are only used to boot them. The 8259s still deliver the IRQs,
+ *	through the boot CPU's LINT0 (virtual wire mode). The APIC timer is a better tick than the PIT: it is
+ *	programmed with one register write, and counts 32 bits.
+ */
+
+#include <linux/clockchips.h>
+#include <linux/init.h>
+#include <linux/jiffies.h>
+#include <linux/linkage.h>
+#include <linux/rcupdate.h>
+#include <linux/smp.h>
+#include <asm/apic.h>
+#include <asm/desc.h>
+#include <asm/hw_irq.h>
+#include <asm/io.h>
+#include <asm/msr.h>
+#include <asm/processor.h>
+#include <asm/stdio.h>
+#include <asm/timer.h>
+
+#define CALIBRATE_MS	50
+
+unsigned long apic_base;
+
+/* APIC timer ticks per second, with the divider at 16 */
+static unsigned long calibration_result;
+
+static void lapic_timer_setup(enum clock_event_mode mode,
+			      struct clock_event_device *evt)
+{
+	switch (mode) {
+	case CLOCK_EVT_MODE_PERIODIC:
+		apic_write(APIC_LVTT, LOCAL_TIMER_VECTOR | APIC_LVT_TIMER_PERIODIC);
+		apic_write(APIC_TMICT, calibration_result / HZ);
+		break;
+	case CLOCK_EVT_MODE_ONESHOT:
+		apic_write(APIC_LVTT, LOCAL_TIMER_VECTOR);
+		break;
+	case CLOCK_EVT_MODE_UNUSED:
+	case CLOCK_EVT_MODE_SHUTDOWN:
+		apic_write(APIC_LVTT, LOCAL_TIMER_VECTOR | APIC_LVT_MASKED);
+		apic_write(APIC_TMICT, 0);
+		break;
+	}
+}
+
+/*
+ * Program the next event, relative to now. In one-shot mode the
+ * count starts with the write, there is nothing else to touch.
+ */
+static int lapic_next_event(unsigned long delta,
+			    struct clock_event_device *evt)
+{
+	apic_write(APIC_TMICT, delta);
+	return 0;
+}
+
+static struct clock_event_device lapic_clockevent = {
+	.name		= "lapic",
+	.features	= CLOCK_EVT_FEAT_PERIODIC | CLOCK_EVT_FEAT_ONESHOT,
+	.shift		= 32,
+	.set_mode	= lapic_timer_setup,
+	.set_next_event	= lapic_next_event,
+	.rating		= 100,
+};
+
+/*
+ * Local APIC timer interrupt, from apic_timer_interrupt in entry.S
+ * with interrupts off.
+ */
+asmlinkage void smp_apic_timer_interrupt(void)
+{
+	ack_APIC_irq();
+	rcu_irq_enter();
+	lapic_clockevent.event_handler(&lapic_clockevent);
+}
+
+/*
+ * Turn the local APIC on in the MSR if the BIOS left it off, and map
+ * its registers.
+ */
+static int __init detect_init_APIC(void)
+{
+	unsigned long l, h;
+
+	if (!cpu_has_apic)
+		return -1;
+
+	rdmsr(MSR_IA32_APICBASE, l, h);
+	if (!(l & MSR_IA32_APICBASE_ENABLE)) {
+		l |= MSR_IA32_APICBASE_ENABLE;
+		wrmsr(MSR_IA32_APICBASE, l, h);
+	}
+
+	apic_base = (unsigned long)
+		ioremap_nocache(l & MSR_IA32_APICBASE_BASE, PAGE_SIZE);
+	if (!apic_base)
+		return -1;
+	printk("Local APIC at 0x%08lx mapped at 0x%08lx\n",
+	       l & MSR_IA32_APICBASE_BASE, apic_base);
+	return 0;
+}
+
+/*
+ * Software-enable this CPU's APIC, in virtual wire mode: on the boot
+ * CPU LINT0 passes the 8259's interrupts through as ExtINT, on the
+ * others it is masked. LINT1 is the NMI.
+ */
+void __init setup_local_APIC(void)
+{
+	unsigned long value;
+
+	/*
+	 * Set Task Priority to 'accept all'.
+	 */
+	value = apic_read(APIC_TASKPRI);
+	value &= ~APIC_TPRI_MASK;
+	apic_write(APIC_TASKPRI, value);
+
+	value = apic_read(APIC_SPIV);
+	value &= ~APIC_VECTOR_MASK;
+	/*
+	 * Enable APIC
+	 */
+	value |= APIC_SPIV_APIC_ENABLED;
+	value |= SPURIOUS_APIC_VECTOR;
+	apic_write(APIC_SPIV, value);
+
+	value = APIC_DM_EXTINT;
+	if (smp_processor_id())
+		value |= APIC_LVT_MASKED;
+	apic_write(APIC_LVT0, value);
+	apic_write(APIC_LVT1, APIC_DM_NMI);
+}
+
+/*
+ * Let the timer count down from the top, masked, while PIT channel 2
+ * times CALIBRATE_MS. Returns ticks per second.
+ */
+static unsigned long __init calibrate_APIC_clock(void)
+{
+	unsigned long end;
+
+	apic_write(APIC_LVTT, LOCAL_TIMER_VECTOR | APIC_LVT_MASKED);
+	apic_write(APIC_TDCR, APIC_TDR_DIV_16);
+
+	pit_calibrate_start(CALIBRATE_MS);
+	apic_write(APIC_TMICT, 0xffffffff);
+	while (!pit_calibrate_done())
+		;
+	end = apic_read(APIC_TMCCT);
+	apic_write(APIC_TMICT, 0);
+
+	return (0xffffffff - end) * (1000 / CALIBRATE_MS);
+}
+
+/*
+ * Set up the boot CPU's APIC timer and hand it the tick, the PIT is
+ * rated below it.
+ */
+void __init setup_boot_APIC_clock(void)
+{
+	if (detect_init_APIC())
+		return;
+	set_intr_gate(SPURIOUS_APIC_VECTOR, spurious_interrupt);
+	set_intr_gate(LOCAL_TIMER_VECTOR, apic_timer_interrupt);
+	setup_local_APIC();
+
+	calibration_result = calibrate_APIC_clock();
+	printk("..... APIC timer speed is %ld.%04ld MHz.\n",
+	       calibration_result / 1000000,
+	       (calibration_result % 1000000) / 100);
+	/*
+	 * If nothing is really counting, leave the tick to the PIT.
+	 */
+	if (calibration_result < 1000000 / HZ) {
+		printk("APIC frequency too slow, disabling apic timer\n");
+		return;
+	}
+
+	lapic_clockevent.mult = div_sc(calibration_result, NSEC_PER_SEC,
+				       lapic_clockevent.shift);
+	lapic_clockevent.max_delta_ns =
+		clockevent_delta2ns(0x7FFFFFFF, &lapic_clockevent);
+	lapic_clockevent.min_delta_ns =
+		clockevent_delta2ns(0xF, &lapic_clockevent);
+	clockevents_register_device(&lapic_clockevent);
+}
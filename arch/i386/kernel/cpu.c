@@ -0,0 +1,127 @@
+/*
+ *  linux/arch/i386/kernel/cpu.c
+ *
+ *  CPU identification through CPUID and the per-CPU control register
+ *  setup that goes with it.
+ */
+
+#include <linux/init.h>
+#include <linux/string.h>
+#include <asm/processor.h>
+#include <asm/stdio.h>
+
+struct cpuinfo_x86 boot_cpu_data = { 0, 0, 0, 0, -1 };
+
+/* CR4 bits every CPU has to run with, see set_in_cr4() */
+unsigned long mmu_cr4_features;
+
+/* Standard macro to see if a specific flag is changeable */
+static inline int flag_is_changeable_p(uint32_t flag)
+{
+	uint32_t f1, f2;
+
+	asm("pushfl\n\t"
+	    "pushfl\n\t"
+	    "popl %0\n\t"
+	    "movl %0,%1\n\t"
+	    "xorl %2,%0\n\t"
+	    "pushl %0\n\t"
+	    "popfl\n\t"
+	    "pushfl\n\t"
+	    "popl %0\n\t"
+	    "popfl\n\t"
+	    : "=&r" (f1), "=&r" (f2)
+	    : "ir" (flag));
+
+	return ((f1^f2) & flag) != 0;
+}
+
+/* Probe for the CPUID instruction */
+static int __init have_cpuid_p(void)
+{
+	return flag_is_changeable_p(0x00200000);	// EFLAGS.ID
+}
+
+/*
+ * This does the hard work of actually picking apart the CPU stuff...
+ */
+void __init identify_cpu(struct cpuinfo_x86 *c)
+{
+	int tfms, misc;
+
+	c->cpuid_level = -1;		/* CPUID not detected */
+	c->x86_vendor = X86_VENDOR_UNKNOWN;
+	c->x86_vendor_id[0] = '\0';	/* Unset */
+	memset(&c->x86_capability, 0, sizeof c->x86_capability);
+
+	if (!have_cpuid_p()) {
+		printk("CPU: no CPUID, assuming 486\n");
+		c->x86 = 4;
+		return;
+	}
+
+	/* Get vendor name */
+	cpuid(0x00000000, &c->cpuid_level,
+	      (int *)&c->x86_vendor_id[0],
+	      (int *)&c->x86_vendor_id[8],
+	      (int *)&c->x86_vendor_id[4]);
+	c->x86_vendor_id[12] = '\0';
+
+	if (!strcmp(c->x86_vendor_id, "GenuineIntel"))
+		c->x86_vendor = X86_VENDOR_INTEL;
+	else if (!strcmp(c->x86_vendor_id, "AuthenticAMD"))
+		c->x86_vendor = X86_VENDOR_AMD;
+
+	/* Intel-defined flags: level 0x00000001 */
+	if (c->cpuid_level >= 0x00000001) {
+		cpuid(0x00000001, &tfms, &misc, (int *)&c->x86_capability[1],
+		      (int *)&c->x86_capability[0]);
+		c->x86 = (tfms >> 8) & 15;
+		c->x86_model = (tfms >> 4) & 15;
+		if (c->x86 == 0xf) {
+			c->x86 += (tfms >> 20) & 0xff;
+			c->x86_model += ((tfms >> 16) & 0xf) << 4;
+		}
+		c->x86_mask = tfms & 15;
+	} else {
+		/* Have CPUID level 0 only - unheard of */
+		c->x86 = 4;
+	}
+
+	/* Structured extended feature flags: level 0x00000007, subleaf 0 */
+	if (c->cpuid_level >= 0x00000007)
+		cpuid(0x00000007, &tfms, (int *)&c->x86_capability[2], &misc, &misc);
+
+	printk("CPU: %s family %d model %d stepping %d, features %08x %08x %08x\n",
+	       c->x86_vendor_id, c->x86, c->x86_model, c->x86_mask,
+	       c->x86_capability[0], c->x86_capability[1],
+	       c->x86_capability[2]);
+}
+
+/*
+ * cpu_init() initializes state that is per-CPU: control register
+ * bits that depend on the features identify_cpu() found.
+ */
+void __init cpu_init(void)
+{
+	unsigned long cr0;
+
+	/*
+	 * Let the kernel use the FPU and SSE: clear EM/TS, set MP, and
+	 * tell the CPU we save state with FXSAVE and handle SIMD
+	 * exceptions. Nothing in the kernel keeps FPU state across a
+	 * context switch yet, SSE is only used by string/bitmap helpers
+	 * that save the XMM registers they clobber (asm/xmm.h).
+	 */
+	__asm__ __volatile__("movl %%cr0,%0" : "=r" (cr0));
+	cr0 &= ~0x0000000cUL;		/* EM | TS */
+	cr0 |= 0x00000002UL;		/* MP */
+	__asm__ __volatile__("movl %0,%%cr0" : : "r" (cr0));
+	if (cpu_has_fpu)
+		__asm__ __volatile__("fninit");
+
+	if (cpu_has_fxsr)
+		set_in_cr4(X86_CR4_OSFXSR);
+	if (cpu_has_xmm)
+		set_in_cr4(X86_CR4_OSXMMEXCPT);
+}
@@ -0,0 +1,147 @@
+/*
+ *  linux/arch/i386/kernel/i8259.c
+ *
+ *  The two cascaded 8259A interrupt controllers of the PC.
+ *
+ *  Every port access costs, and under a hypervisor each one traps, so
+ *  the masks are cached instead of read back, and an interrupt costs
+ *  a single specific EOI (two for the slave's lines).
+ */
+
+#include <linux/init.h>
+#include <linux/spinlock.h>
+#include <asm/hw_irq.h>
+#include <asm/io.h>
+#include <asm/system.h>
+
+#define PIC_MASTER_CMD		0x20
+#define PIC_MASTER_IMR		0x21
+#define PIC_SLAVE_CMD		0xa0
+#define PIC_SLAVE_IMR		0xa1
+
+#define PIC_CASCADE_IR		2	/* the slave hangs off the master's IR2 */
+
+/*
+ * The IRQs are masked from any CPU, each under its own desc->lock;
+ * i8259A_lock keeps two of them from losing each other's update of
+ * the shared mask, and keeps the ISR reads and the setup together.
+ */
+spinlock_t i8259A_lock = SPIN_LOCK_UNLOCKED;
+
+/*
+ * This contains the irq mask for both 8259A irq controllers,
+ */
+static unsigned int cached_irq_mask = 0xffff;
+
+#define __byte(x,y)	(((unsigned char *)&(y))[x])
+#define cached_21	(__byte(0,cached_irq_mask))
+#define cached_A1	(__byte(1,cached_irq_mask))
+
+/*
+ * Only the controller whose mask changed is written to.
+ */
+void disable_8259A_irq(unsigned int irq)
+{
+	unsigned int mask = 1 << irq;
+	unsigned long flags;
+
+	spin_lock_irqsave(&i8259A_lock, flags);
+	cached_irq_mask |= mask;
+	if (irq & 8)
+		outb(cached_A1,PIC_SLAVE_IMR);
+	else
+		outb(cached_21,PIC_MASTER_IMR);
+	spin_unlock_irqrestore(&i8259A_lock, flags);
+}
+
+void enable_8259A_irq(unsigned int irq)
+{
+	unsigned int mask = ~(1 << irq);
+	unsigned long flags;
+
+	spin_lock_irqsave(&i8259A_lock, flags);
+	cached_irq_mask &= mask;
+	if (irq & 8)
+		outb(cached_A1,PIC_SLAVE_IMR);
+	else
+		outb(cached_21,PIC_MASTER_IMR);
+	spin_unlock_irqrestore(&i8259A_lock, flags);
+}
+
+/*
+ * Acknowledge the interrupt once do_IRQ() has run the handlers. The
+ * handlers run with interrupts off, so the line doesn't need masking
+ * meanwhile: a 'Specific EOI' does the job with one port write.
+ */
+void i8259A_eoi(unsigned int irq)
+{
+	if (irq & 8) {
+		outb(0x60+(irq&7),PIC_SLAVE_CMD);	/* 'Specific EOI' to slave */
+		outb(0x60+PIC_CASCADE_IR,PIC_MASTER_CMD); /* 'Specific EOI' to master-IRQ2 */
+	} else {
+		outb(0x60+irq,PIC_MASTER_CMD);	/* 'Specific EOI to master */
+	}
+}
+
+/*
+ * A request that goes away before the 8259A delivers it still shows
+ * up, as the lowest priority line of its controller: IRQ7 or IRQ15.
+ * Only those two need the in-service register read to tell; a
+ * spurious one must not get an EOI, except the master's for the
+ * cascade if it came from the slave.
+ */
+int i8259A_irq_spurious(unsigned int irq)
+{
+	int isr;
+
+	if ((irq & 7) != 7)
+		return 0;
+	spin_lock(&i8259A_lock);
+	if (irq & 8) {
+		outb(0x0B,PIC_SLAVE_CMD);	/* ISR register */
+		isr = inb(PIC_SLAVE_CMD);
+		outb(0x0A,PIC_SLAVE_CMD);	/* back to the IRR register */
+		if (!(isr & 0x80))
+			outb(0x60+PIC_CASCADE_IR,PIC_MASTER_CMD);
+	} else {
+		outb(0x0B,PIC_MASTER_CMD);
+		isr = inb(PIC_MASTER_CMD);
+		outb(0x0A,PIC_MASTER_CMD);
+	}
+	spin_unlock(&i8259A_lock);
+	return !(isr & 0x80);
+}
+
+/*
+ * Move the controllers' vectors to FIRST_EXTERNAL_VECTOR (the BIOS
+ * leaves the master on top of the CPU exceptions) and mask
+ * everything but the cascade.
+ */
+void __init init_8259A(void)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&i8259A_lock, flags);
+
+	outb(0xff, PIC_MASTER_IMR);	/* mask all of 8259A-1 */
+	outb(0xff, PIC_SLAVE_IMR);	/* mask all of 8259A-2 */
+
+	/*
+	 * outb_p - this has to work on a wide range of PC hardware.
+	 */
+	outb_p(0x11, PIC_MASTER_CMD);	/* ICW1: select 8259A-1 init */
+	outb_p(FIRST_EXTERNAL_VECTOR + 0, PIC_MASTER_IMR);	/* ICW2: 8259A-1 IR0-7 mapped to 0x20-0x27 */
+	outb_p(1U << PIC_CASCADE_IR, PIC_MASTER_IMR);	/* 8259A-1 (the master) has a slave on IR2 */
+	outb_p(0x01, PIC_MASTER_IMR);	/* master expects normal EOI */
+
+	outb_p(0x11, PIC_SLAVE_CMD);	/* ICW1: select 8259A-2 init */
+	outb_p(FIRST_EXTERNAL_VECTOR + 8, PIC_SLAVE_IMR);	/* ICW2: 8259A-2 IR0-7 mapped to 0x28-0x2f */
+	outb_p(PIC_CASCADE_IR, PIC_SLAVE_IMR);	/* 8259A-2 is a slave on master's IR2 */
+	outb_p(0x01, PIC_SLAVE_IMR);	/* (slave's support for AEOI in flat mode is to be investigated) */
+
+	cached_irq_mask = 0xffff & ~(1 << PIC_CASCADE_IR);
+	outb(cached_21, PIC_MASTER_IMR);	/* restore master IRQ mask */
+	outb(cached_A1, PIC_SLAVE_IMR);	/* restore slave IRQ mask */
+
+	spin_unlock_irqrestore(&i8259A_lock, flags);
+}
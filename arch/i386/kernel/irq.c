@@ -0,0 +1,307 @@
+/*
+ *	linux/arch/i386/kernel/irq.c
+ *
+ *	Copyright (C) 1992, 1998 Linus Torvalds, Ingo Molnar
+ *
+ * This file contains the code used by various IRQ handling routines:
+ * asking for different IRQ's should be done through these routines
+ * instead of just grabbing them. Thus setups with different IRQ numbers
+ * shouldn't result in any weird surprises, and installing new handlers
+ * should be easier.
+ */
+
+#include <linux/clockchips.h>
+#include <linux/errno.h>
+#include <linux/init.h>
+#include <linux/interrupt.h>
+#include <linux/kernel.h>
+#include <linux/rcupdate.h>
+#include <linux/slab.h>
+#include <linux/spinlock.h>
+#include <asm/desc.h>
+#include <asm/hw_irq.h>
+#include <asm/stdio.h>
+#include <asm/system.h>
+
+/*
+ * One per IRQ line: the chain of handlers and how many times the line
+ * has been disabled.
+ */
+#define IRQ_INPROGRESS	1	/* the handlers are running */
+
+typedef struct {
+	struct irqaction *action;	/* IRQ action list */
+	volatile unsigned int status;	/* IRQ_INPROGRESS */
+	unsigned int depth;		/* nested irq disables */
+	unsigned long count;		/* interrupts taken */
+	unsigned long unhandled;	/* ... that no handler claimed */
+	spinlock_t lock;
+} irq_desc_t;
+
+static irq_desc_t irq_desc[NR_IRQS];
+
+/*
+ * do_IRQ handles all normal device IRQ's, entered from
+ * common_interrupt with interrupts off. Every handler on the line is
+ * asked, a shared line can have several devices interrupting at once.
+ * The 8259As only interrupt the boot CPU, but the line may be disabled
+ * from another one: an interrupt raised just before that finds the
+ * line disabled and is dropped, disable_irq() has returned already.
+ */
+fastcall void do_IRQ(int irq)
+{
+	irq_desc_t *desc = irq_desc + irq;
+	struct irqaction *action;
+	int handled = 0;
+
+	if (i8259A_irq_spurious(irq))
+		return;
+
+	rcu_irq_enter();
+	tick_irq_enter();
+	spin_lock(&desc->lock);
+	desc->count++;
+	if (desc->depth) {
+		spin_unlock(&desc->lock);
+		goto out;
+	}
+	desc->status |= IRQ_INPROGRESS;
+	spin_unlock(&desc->lock);
+
+	for (action = desc->action; action; action = action->next)
+		handled |= action->handler(irq, action->dev_id);
+	if (!handled)
+		desc->unhandled++;
+
+	spin_lock(&desc->lock);
+	desc->status &= ~IRQ_INPROGRESS;
+	spin_unlock(&desc->lock);
+out:
+	i8259A_eoi(irq);
+}
+
+/**
+ *	disable_irq_nosync - disable an irq without waiting
+ *	@irq: Interrupt to disable
+ *
+ *	Disable the selected interrupt line. Disables of an interrupt
+ *	stack. Unlike disable_irq() this doesn't wait for the handlers
+ *	to finish if they are running on the boot CPU, so it may be
+ *	called from the line's own handler.
+ */
+void disable_irq_nosync(unsigned int irq)
+{
+	irq_desc_t *desc = irq_desc + irq;
+	unsigned long flags;
+
+	spin_lock_irqsave(&desc->lock, flags);
+	if (!desc->depth++)
+		disable_8259A_irq(irq);
+	spin_unlock_irqrestore(&desc->lock, flags);
+}
+
+/**
+ *	disable_irq - disable an irq and wait for completion
+ *	@irq: Interrupt to disable
+ *
+ *	Disable the selected interrupt line, and wait for the handlers
+ *	to return if they are running on the boot CPU right now. Calling
+ *	this from the line's own handler deadlocks.
+ */
+void disable_irq(unsigned int irq)
+{
+	disable_irq_nosync(irq);
+	while (irq_desc[irq].status & IRQ_INPROGRESS)
+		cpu_relax();
+}
+
+/**
+ *	enable_irq - enable interrupt handling on an irq
+ *	@irq: Interrupt to enable
+ *
+ *	Re-enables the processing of interrupts on this IRQ line
+ *	providing no disable_irq calls are now in effect.
+ */
+void enable_irq(unsigned int irq)
+{
+	irq_desc_t *desc = irq_desc + irq;
+	unsigned long flags;
+
+	spin_lock_irqsave(&desc->lock, flags);
+	switch (desc->depth) {
+	case 1:
+		enable_8259A_irq(irq);
+		/* fall-through */
+	default:
+		desc->depth--;
+		break;
+	case 0:
+		printk("enable_irq(%u) unbalanced\n", irq);
+	}
+	spin_unlock_irqrestore(&desc->lock, flags);
+}
+
+/*
+ * Add @new to the end of the line's chain. The line is unmasked with
+ * its first handler. Returns -EBUSY if the line is taken and the
+ * handlers don't both agree to share it.
+ */
+int setup_irq(unsigned int irq, struct irqaction *new)
+{
+	irq_desc_t *desc = irq_desc + irq;
+	struct irqaction *old, **p;
+	unsigned long flags;
+	int shared = 0;
+
+	spin_lock_irqsave(&desc->lock, flags);
+	p = &desc->action;
+	if ((old = *p) != NULL) {
+		/* Can't share interrupts unless both agree to */
+		if (!(old->flags & new->flags & SA_SHIRQ)) {
+			spin_unlock_irqrestore(&desc->lock, flags);
+			return -EBUSY;
+		}
+
+		/* add new interrupt at end of irq queue */
+		do {
+			p = &old->next;
+			old = *p;
+		} while (old);
+		shared = 1;
+	}
+
+	*p = new;
+
+	if (!shared) {
+		desc->depth = 0;
+		enable_8259A_irq(irq);
+	}
+	spin_unlock_irqrestore(&desc->lock, flags);
+	return 0;
+}
+
+/**
+ *	request_irq - allocate an interrupt line
+ *	@irq: Interrupt line to allocate
+ *	@handler: Function to be called when the IRQ occurs
+ *	@irqflags: Interrupt type flags
+ *	@devname: An ascii name for the claiming device
+ *	@dev_id: A cookie passed back to the handler function
+ *
+ *	This call allocates interrupt resources and enables the
+ *	interrupt line and IRQ handling. From the point this
+ *	call is made your handler function may be invoked. Since
+ *	your handler function must clear any interrupt the board
+ *	raises, you must take care both to initialise your hardware
+ *	and to set up the interrupt handler in the right order.
+ *
+ *	Dev_id must be globally unique. Normally the address of the
+ *	device data structure is used as the cookie. Since the handler
+ *	receives this value it makes sense to use it.
+ *
+ *	If your interrupt is shared you must pass a non NULL dev_id
+ *	as this is required when freeing the interrupt.
+ */
+int request_irq(unsigned int irq, irq_handler_t handler,
+		unsigned long irqflags, const char *devname, void *dev_id)
+{
+	struct irqaction *action;
+	int retval;
+
+	/*
+	 * Sanity-check: shared interrupts must pass in a real dev-ID,
+	 * otherwise we'll have trouble later trying to figure out
+	 * which interrupt is which (messes up the interrupt freeing
+	 * logic etc).
+	 */
+	if ((irqflags & SA_SHIRQ) && !dev_id)
+		return -EINVAL;
+	if (irq >= NR_IRQS)
+		return -EINVAL;
+	if (!handler)
+		return -EINVAL;
+
+	action = kmalloc(sizeof(struct irqaction), GFP_KERNEL);
+	if (!action)
+		return -ENOMEM;
+
+	action->handler = handler;
+	action->flags = irqflags;
+	action->name = devname;
+	action->next = NULL;
+	action->dev_id = dev_id;
+
+	retval = setup_irq(irq, action);
+	if (retval)
+		kfree(action);
+	return retval;
+}
+
+/**
+ *	free_irq - free an interrupt
+ *	@irq: Interrupt line to free
+ *	@dev_id: Device identity to free
+ *
+ *	Remove an interrupt handler. The handler is removed and if the
+ *	interrupt line is no longer in use by any driver it is disabled.
+ *	On a shared IRQ the caller must ensure the interrupt is disabled
+ *	on the card it drives before calling this function.
+ */
+void free_irq(unsigned int irq, void *dev_id)
+{
+	irq_desc_t *desc;
+	struct irqaction **p;
+	unsigned long flags;
+
+	if (irq >= NR_IRQS)
+		return;
+
+	desc = irq_desc + irq;
+	spin_lock_irqsave(&desc->lock, flags);
+	p = &desc->action;
+	for (;;) {
+		struct irqaction *action = *p;
+		if (action) {
+			struct irqaction **pp = p;
+			p = &action->next;
+			if (action->dev_id != dev_id)
+				continue;
+
+			/* Found it - now remove it from the list of entries */
+			*pp = action->next;
+			if (!desc->action)
+				disable_8259A_irq(irq);
+			spin_unlock_irqrestore(&desc->lock, flags);
+			kfree(action);
+			return;
+		}
+		printk("Trying to free free IRQ%d\n",irq);
+		spin_unlock_irqrestore(&desc->lock, flags);
+		return;
+	}
+}
+
+static irqreturn_t no_action(int irq, void *dev_id)
+{
+	return IRQ_NONE;
+}
+
+/*
+ * IRQ2 is cascade interrupt to second interrupt controller
+ */
+static struct irqaction irq2 = { no_action, 0, "cascade", NULL, NULL };
+
+void __init init_IRQ(void)
+{
+	int i;
+
+	init_8259A();
+
+	for (i = 0; i < NR_IRQS; i++) {
+		irq_desc[i].action = NULL;
+		irq_desc[i].depth = 1;
+		spin_lock_init(&irq_desc[i].lock);
+		set_intr_gate(FIRST_EXTERNAL_VECTOR + i, interrupt[i]);
+	}
+	setup_irq(2, &irq2);
+}
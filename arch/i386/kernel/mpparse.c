@@ -0,0 +1,274 @@
+/*
+ *	Intel Multiprocessor Specification 1.1 and 1.4
+ *	compliant MP-table parsing routines.
+ *
+ *	(c) 1995 Alan Cox, Building #3 <alan@redhat.com>
+ *	(c) 1998, 1999, 2000 Ingo Molnar <mingo@redhat.com>
+ *
+ *	Fixes
+ *		Erich Boleyn	:	MP v1.4 and additional changes.
+ *		Alan Cox	:	Added EBDA scanning
+ *		Ingo Molnar	:	various cleanups and rewrites
+ *
+ *	Only the processors are looked at, there is no I/O APIC support.
+ *	The ACPI MADT (acpi.c) comes first when the firmware has one, the
+ *	MP table is the fallback for the machines without ACPI.
+ */
+
+#include <linux/acpi.h>
+#include <linux/bootmem.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/mm.h>
+#include <linux/string.h>
+#include <asm/apicdef.h>
+#include <asm/io.h>
+#include <asm/mpspec.h>
+#include <asm/page.h>
+#include <asm/stdio.h>
+
+#ifdef CONFIG_X86_LOCAL_APIC
+
+/* Have we found an MP table or an ACPI RSDP */
+int smp_found_config;
+
+/* The processors' local APIC IDs, in firmware order */
+int num_processors;
+int bios_cpu_apicid[NR_CPUS];
+
+unsigned long mp_lapic_addr;
+
+static struct intel_mp_floating *mpf_found;
+
+/*
+ * Checksum an MP configuration block.
+ */
+static int __init mpf_checksum(unsigned char *mp, int len)
+{
+	int sum = 0;
+
+	while (len--)
+		sum += *mp++;
+
+	return sum & 0xFF;
+}
+
+void __init mp_register_lapic(int id, int enabled)
+{
+	if (!enabled) {
+		printk("Processor #%d disabled\n", id);
+		return;
+	}
+	if (num_processors >= NR_CPUS) {
+		printk(KERN_WARNING "WARNING: NR_CPUS limit of %i reached."
+			"  Processor #%d ignored.\n", NR_CPUS, id);
+		return;
+	}
+	bios_cpu_apicid[num_processors++] = id;
+	printk("Processor #%d\n", id);
+}
+
+/*
+ * The firmware tables can be anywhere below 4GB. Whatever is under
+ * high_memory is in the direct map already, the rest (the ACPI tables
+ * usually sit right at the top of RAM) is ioremap()ed: only call this
+ * after vmalloc_init().
+ */
+void * __init mp_map_table(unsigned long phys, unsigned long size)
+{
+	if (phys + size <= virt_to_phys(high_memory))
+		return phys_to_virt(phys);
+	return ioremap(phys, size);
+}
+
+void __init mp_unmap_table(void *virt)
+{
+	iounmap(virt);		/* nothing to do for the direct map */
+}
+
+static int __init smp_read_mpc(struct mp_config_table *mpc)
+{
+	char str[16];
+	int count = sizeof(*mpc);
+	unsigned char *mpt = ((unsigned char *)mpc) + count;
+
+	if (memcmp(mpc->mpc_signature, MPC_SIGNATURE, 4)) {
+		printk(KERN_ERR "SMP mptable: bad signature [%c%c%c%c]!\n",
+			mpc->mpc_signature[0],
+			mpc->mpc_signature[1],
+			mpc->mpc_signature[2],
+			mpc->mpc_signature[3]);
+		return 0;
+	}
+	if (mpf_checksum((unsigned char *)mpc, mpc->mpc_length)) {
+		printk(KERN_ERR "SMP mptable: checksum error!\n");
+		return 0;
+	}
+	memcpy(str, mpc->mpc_oem, 8);
+	str[8] = 0;
+	printk("OEM ID: %s ", str);
+
+	memcpy(str, mpc->mpc_productid, 12);
+	str[12] = 0;
+	printk("Product ID: %s ", str);
+
+	printk("APIC at: 0x%lX\n", mpc->mpc_lapic);
+	mp_lapic_addr = mpc->mpc_lapic;
+
+	/*
+	 *	Now process the configuration blocks.
+	 */
+	while (count < mpc->mpc_length) {
+		switch (*mpt) {
+			case MP_PROCESSOR:
+			{
+				struct mpc_config_processor *m =
+					(struct mpc_config_processor *)mpt;
+
+				mp_register_lapic(m->mpc_apicid,
+						  m->mpc_cpuflag & CPU_ENABLED);
+				mpt += sizeof(*m);
+				count += sizeof(*m);
+				break;
+			}
+			case MP_BUS:
+			case MP_IOAPIC:
+			case MP_INTSRC:
+			case MP_LINTSRC:
+				mpt += MPC_ENTRY_SIZE;
+				count += MPC_ENTRY_SIZE;
+				break;
+			default:
+				/* can't step over what we don't know */
+				count = mpc->mpc_length;
+				break;
+		}
+	}
+	return num_processors;
+}
+
+/*
+ * Find the processors: in the MADT if there is one, else in the MP
+ * table. Called at SMP boot time, the tables are mapped here.
+ */
+void __init get_smp_config(void)
+{
+	struct intel_mp_floating *mpf = mpf_found;
+	struct mp_config_table *mpc;
+	unsigned long size;
+
+	if (!acpi_boot_init())
+		return;
+	if (!mpf)
+		return;
+
+	printk("Intel MultiProcessor Specification v1.%d\n",
+	       mpf->mpf_specification);
+
+	if (mpf->mpf_feature1 != 0) {
+		/*
+		 * One of the default configurations: two processors,
+		 * APIC IDs 0 and 1, APIC at the default address.
+		 */
+		printk("Default MP configuration #%d\n", mpf->mpf_feature1);
+		mp_lapic_addr = APIC_DEFAULT_PHYS_BASE;
+		mp_register_lapic(0, 1);
+		mp_register_lapic(1, 1);
+		return;
+	}
+	if (!mpf->mpf_physptr)
+		return;
+
+	mpc = mp_map_table(mpf->mpf_physptr, sizeof(*mpc));
+	if (!mpc)
+		return;
+	size = mpc->mpc_length;
+	mp_unmap_table(mpc);
+	if (size < sizeof(*mpc))
+		return;
+	mpc = mp_map_table(mpf->mpf_physptr, size);
+	if (!mpc)
+		return;
+	if (!smp_read_mpc(mpc))
+		printk(KERN_ERR "BIOS bug, MP table errors detected!...\n");
+	mp_unmap_table(mpc);
+}
+
+static int __init smp_scan_config(unsigned long base, unsigned long length)
+{
+	unsigned long *bp = phys_to_virt(base);
+	struct intel_mp_floating *mpf;
+
+	while (length > 0) {
+		mpf = (struct intel_mp_floating *)bp;
+		if ((*bp == SMP_MAGIC_IDENT) &&
+			(mpf->mpf_length == 1) &&
+			!mpf_checksum((unsigned char *)bp, 16) &&
+			((mpf->mpf_specification == 1)
+				|| (mpf->mpf_specification == 4)) ) {
+
+			smp_found_config = 1;
+			printk("found SMP MP-table at %08lx\n",
+						virt_to_phys(mpf));
+			reserve_bootmem(virt_to_phys(mpf), PAGE_SIZE);
+			/*
+			 * The table it points to may be in RAM too, keep
+			 * it from being handed out before it is read.
+			 */
+			if (mpf->mpf_physptr &&
+			    mpf->mpf_physptr < (max_low_pfn << PAGE_SHIFT)) {
+				unsigned long end = max_low_pfn << PAGE_SHIFT;
+				unsigned long size = PAGE_SIZE;
+
+				if (mpf->mpf_physptr + size > end)
+					size = end - mpf->mpf_physptr;
+				reserve_bootmem(mpf->mpf_physptr, size);
+			}
+			mpf_found = mpf;
+			return 1;
+		}
+		bp += 4;
+		length -= 16;
+	}
+	return 0;
+}
+
+/*
+ * Called from setup_memory(), with only low memory mapped: look for
+ * the ACPI RSDP and the MP floating pointer, which both live below
+ * 1MB, and reserve the MP structures.
+ */
+void __init find_smp_config(void)
+{
+	unsigned int address;
+
+	if (!acpi_find_rsdp())
+		smp_found_config = 1;
+
+	/*
+	 * FIXME: Linux assumes you have 640K of base ram..
+	 * this continues the error...
+	 *
+	 * 1) Scan the bottom 1K for a signature
+	 * 2) Scan the top 1K of base RAM
+	 * 3) Scan the 64K of bios
+	 */
+	if (smp_scan_config(0x0, 0x400) ||
+		smp_scan_config(639 * 0x400, 0x400) ||
+			smp_scan_config(0xF0000, 0x10000))
+		return;
+	/*
+	 * If it is an SMP machine we should know now, unless the
+	 * configuration is in an EISA/MCA bus machine with an
+	 * extended bios data area.
+	 *
+	 * there is a real-mode segmented pointer pointing to the
+	 * 4K EBDA area at 0x40E, calculate and scan it here.
+	 */
+	address = *(unsigned short *)phys_to_virt(0x40E);
+	address <<= 4;
+	if (address)
+		smp_scan_config(address, 0x1000);
+}
+
+#endif /* CONFIG_X86_LOCAL_APIC */
@@ -0,0 +1,68 @@
+/*
+ *  linux/arch/i386/kernel/process.c
+ *
+ *  The idle loop.
+ */
+
+#include <linux/clockchips.h>
+#include <linux/console.h>
+#include <linux/mm.h>
+#include <linux/rcupdate.h>
+#include <linux/smp.h>
+#include <asm/system.h>
+
+/*
+ * We use this if we don't have any better idle routine..
+ * Entered with interrupts off, "sti; hlt" leaves no window for a wakeup
+ * to slip in before the halt.
+ */
+static void default_idle(void)
+{
+	safe_halt();
+}
+
+/*
+ * The idle thread. With nothing else to run, clear free pages for
+ * __GFP_ZERO allocations and halt once every zone's pool is full.
+ * printk_deferred() messages are written out before halting. The
+ * tick is stopped for the halt: only the next timer wakes us up.
+ * The tick belongs to the boot CPU, the others just halt.
+ *
+ * Every pass is an RCU quiescent state. A CPU with RCU callbacks
+ * queued doesn't halt for good: the boot CPU keeps its tick, the
+ * others get no timer interrupt at all and so don't halt.
+ */
+void cpu_idle(void)
+{
+	int cpu = smp_processor_id();
+
+	/* endless idle loop with no priority at all */
+	for (;;) {
+		rcu_qsctr_inc(cpu);
+		if (rcu_pending(cpu))
+			rcu_check_callbacks(cpu);
+		// 还有页面可以预先清零就先不停机
+		if (idle_zero_page())
+			continue;
+		console_flush();
+		local_irq_disable();
+		if (rcu_needs_cpu(cpu)) {
+			if (cpu) {
+				local_irq_enable();
+				cpu_relax();
+			} else
+				default_idle();
+			continue;
+		}
+		rcu_enter_nohz(cpu);
+		if (cpu) {
+			default_idle();
+			rcu_exit_nohz(cpu);
+			continue;
+		}
+		tick_nohz_idle_enter();
+		default_idle();
+		tick_nohz_idle_exit();
+		rcu_exit_nohz(cpu);
+	}
+}
@@ -8,7 +8,10 @@
 #include <linux/bootmem.h>
 #include <linux/kernel.h>
 #include <asm/pgtable.h>
-#include <linux/bootmem.h>
+#include <linux/memblock.h>
+#include <linux/highmem.h>
+#include <asm/processor.h>
+#include <asm/mpspec.h>
 
 // 用户定义的 highmem_pages 大小（高端内存的页数）
 static unsigned int highmem_pages __initdata = -1;
@@ -52,8 +55,11 @@ void __init biosmap_init() {
   mmap_entry_t *mmap = (mmap_entry_t *)mmap_addr;
   for (; (uint32_t)mmap < mmap_addr + mmap_length; ++mmap) {
     // 将当前条目的信息存储到 biosmap 数据结构中
-    biosmap.map[cnt].addr = mmap->base_addr_low;
-    biosmap.map[cnt].size = mmap->length_low;
+    // 地址和长度都是 64 位的，4GB 以上的内存也要登记
+    biosmap.map[cnt].addr =
+        ((unsigned long long)mmap->base_addr_high << 32) | mmap->base_addr_low;
+    biosmap.map[cnt].size =
+        ((unsigned long long)mmap->length_high << 32) | mmap->length_low;
     biosmap.map[cnt].type = mmap->type;
     cnt++;
   }
@@ -315,6 +321,7 @@ static void __init print_memory_map(char *who) {
  */
 #define MAXMEM_PFN	PFN_DOWN(MAXMEM)
 #define MAX_NONPAE_PFN	(1 << 20)
+#define MAX_PAE_PFN	(1 << 24)	// PAE 页表项最多表示 36 位物理地址，即 64GB
 
 static void __init find_max_pfn(void)
 {
@@ -323,7 +330,7 @@ static void __init find_max_pfn(void)
 
 	max_pfn = 0;		// 初始化 max_pfn 为 0，max_pfn 用于存储最大的物理帧号
 	for (i = 0; i < e820.nr_map; i++) {
-		unsigned long start, end;	// 定义两个无符号长整型变量，用于存储内存区块的起始和结束帧号
+		unsigned long long start, end;	// 内存区块的起始和结束帧号，4GB 以上的地址同样计算
 		/* RAM? */
 		if (e820.map[i].type != E820_RAM)	// 检查 e820 映射表中当前项的类型是否为 RAM，如果不是，则跳过此项
 			continue;
@@ -331,6 +338,10 @@ static void __init find_max_pfn(void)
 		start = PFN_UP(e820.map[i].addr);
 		// 计算当前内存区块的结束帧号，PFN_DOWN 是一个宏，用于将地址向下取整到最近的页边界
 		end = PFN_DOWN(e820.map[i].addr + e820.map[i].size);
+#ifdef CONFIG_X86_PAE
+		if (end > MAX_PAE_PFN)	// 超过 64GB 的部分 PAE 页表也映射不到
+			end = MAX_PAE_PFN;
+#endif
 		if (start >= end)	// 检查计算出的起始帧号是否大于等于结束帧号，如果是，则跳过此项
 			continue;
 		if (end > max_pfn)	// 如果计算出的结束帧号大于当前的 max_pfn，则更新 max_pfn
@@ -361,10 +372,12 @@ static unsigned long __init find_max_low_pfn(void)
 		// 如果未启用高端内存支持，则打印警告信息，指示将只使用可直接寻址的最大内存量
 		printk(KERN_WARNING "Warning only %ldMB will be used.\n",
 					MAXMEM>>20);
+#ifndef CONFIG_X86_PAE
 		if (max_pfn > MAX_NONPAE_PFN)
 			// 如果最大PFN超过了非PAE内核的最大PFN，则打印警告信息，建议使用启用PAE的内核
 			printk(KERN_WARNING "Use a PAE enabled kernel.\n");
 		else
+#endif
 			printk(KERN_WARNING "Use a HIGHMEM enabled kernel.\n");
 #else /* !CONFIG_HIGHMEM */
 #ifndef CONFIG_X86_PAE
@@ -402,6 +415,7 @@ static unsigned long __init find_max_low_pfn(void)
 	return max_low_pfn;
 }
 
+#ifndef CONFIG_NO_BOOTMEM
 /*
  * Register fully available low RAM pages with the bootmem allocator.
  */
@@ -449,6 +463,42 @@ static void __init register_bootmem_low_pages(unsigned long max_low_pfn)
 		free_bootmem(PFN_PHYS(curr_pfn), PFN_PHYS(size));
 	}
 }
+#endif
+
+#ifdef CONFIG_NO_BOOTMEM
+/*
+ * Feed the E820_RAM ranges straight into memblock. Unlike
+ * register_bootmem_low_pages() this covers all RAM, allocations are
+ * kept below max_low_pfn by memblock.current_limit instead.
+ */
+// 直接用 e820 中的可用内存区间建立 memblock.memory，每个区间只需一次操作
+static void __init memblock_x86_fill(void)
+{
+	int i;
+
+	for (i = 0; i < e820.nr_map; i++) {
+		unsigned long long start, end;
+
+		if (e820.map[i].type != E820_RAM)
+			continue;
+		// 只登记完整的页
+		start = PFN_PHYS((unsigned long long)PFN_UP(e820.map[i].addr));
+		end = PFN_PHYS((unsigned long long)PFN_DOWN(e820.map[i].addr + e820.map[i].size));
+#ifdef CONFIG_X86_PAE
+		// PAE 页表项表示不了的部分先丢掉
+		if (end > PFN_PHYS((unsigned long long)MAX_PAE_PFN))
+			end = PFN_PHYS((unsigned long long)MAX_PAE_PFN);
+#else
+		// phys_addr_t 表示不了的部分先丢掉
+		if (end > (phys_addr_t)~0UL)
+			end = (phys_addr_t)~0UL & PAGE_MASK;
+#endif
+		if (start >= end)
+			continue;
+		memblock_add(start, end - start);
+	}
+}
+#endif
 
 static unsigned long __init setup_memory() {
   printk("setup_memory start\n");
@@ -481,7 +531,11 @@ static unsigned long __init setup_memory() {
 	bootmap_size = init_bootmem(start_pfn, max_low_pfn);	 // 初始化启动时的内存分配器，并返回分配的引导映射（bootmap）大小
   printk("bootmap_size = 0x%x\n", bootmap_size);
 
+#ifdef CONFIG_NO_BOOTMEM
+  memblock_x86_fill();		// 由 e820 建立 memblock，不需要位图
+#else
   register_bootmem_low_pages(max_low_pfn);	// 注册低端内存（low memory）的页帧
+#endif
   
   /*
 	 * Reserve the bootmem bitmap itself as well. We do this in two
@@ -536,6 +590,10 @@ static unsigned long __init setup_memory() {
 	}
 #endif
 
+#ifdef CONFIG_NO_BOOTMEM
+  memblock_dump_all();
+#endif
+
   printk("setup_memory end\n");
 
 	return max_low_pfn;
@@ -563,6 +621,11 @@ void __init setup_arch() {
 
   unsigned long max_low_pfn;
 
+  identify_cpu(&boot_cpu_data);  // 识别 CPU 型号和特性（cpuid）
+  cpu_init();                    // 打开 FPU/SSE 支持
+  clear_page_init();             // 按 CPU 特性选择 clear_page 的实现
+  string_init();                 // 以及 memset/memcpy 等的实现
+
   setup_memory_region();  // 设置内存区域。
 
   // 设置内存，并将最大低端页面帧号存储在max_low_pfn中。
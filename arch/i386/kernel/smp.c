@@ -0,0 +1,258 @@
+/*
+ *	Intel SMP support routines.
+ *
+ *	(c) 1995 Alan Cox, Building #3 <alan@redhat.com>
+ *	(c) 1998-99, 2000 Ingo Molnar <mingo@redhat.com>
+ *
+ *	This code is released under the GNU General Public License version 2 or
+ *	later.
+ *
+ *	One CPU asks the others to flush kernel mappings out of their
+ *	TLBs: vmalloc areas and pkmap entries are handed out again once
+ *	they are unmapped, and the identity mapping goes away after boot.
+ *	There is no user address space, so every flush is for everybody.
+ *	Anything else that has to run on every CPU, like swapping out
+ *	the slab's per-cpu arrays, goes through smp_call_function().
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/linkage.h>
+#include <linux/smp.h>
+#include <linux/spinlock.h>
+#include <asm/apic.h>
+#include <asm/bitops.h>
+#include <asm/desc.h>
+#include <asm/hw_irq.h>
+#include <asm/pgtable.h>
+#include <asm/processor.h>
+#include <asm/system.h>
+
+#ifdef CONFIG_SMP
+
+/*
+ * One physically addressed fixed IPI per CPU in @mask. Interrupts are
+ * off so that nothing on this CPU writes ICR2 between our two writes.
+ */
+static void send_IPI_mask(unsigned long mask, int vector)
+{
+	unsigned long flags;
+	int cpu;
+
+	local_irq_save(flags);
+	for (cpu = 0; cpu < NR_CPUS; cpu++) {
+		if (!(mask & (1UL << cpu)))
+			continue;
+		while (apic_read(APIC_ICR) & APIC_ICR_BUSY)
+			cpu_relax();
+		apic_write(APIC_ICR2, SET_APIC_DEST_FIELD(x86_cpu_to_apicid[cpu]));
+		apic_write(APIC_ICR, APIC_DM_FIXED | vector);
+	}
+	local_irq_restore(flags);
+}
+
+/*
+ * TLB flush requests. The sender holds tlbstate_lock, so there is only
+ * one range at a time; flush_cpumask has a bit for each CPU that hasn't
+ * flushed it yet, it is empty again before the lock is dropped.
+ */
+static spinlock_t tlbstate_lock = SPIN_LOCK_UNLOCKED;
+static volatile unsigned long flush_cpumask;
+static unsigned long flush_va_start, flush_va_end;
+
+/*
+ * The same for function calls: call_lock holds the one request,
+ * call_cpumask has a bit for each CPU that hasn't run it yet (or,
+ * with @wait, hasn't finished it).
+ */
+struct call_data_struct {
+	void (*func) (void *info);
+	void *info;
+	int wait;
+};
+
+static spinlock_t call_lock = SPIN_LOCK_UNLOCKED;
+static volatile unsigned long call_cpumask;
+static struct call_data_struct *call_data;
+
+/*
+ * Flush the range asked for, if it is for us. An IPI can come late,
+ * after we already flushed from flush_tlb_others() below: then our bit
+ * is clear, or set for the next request, whose range is up already.
+ */
+static void do_flush_tlb(int cpu)
+{
+	if (!test_bit(cpu, &flush_cpumask))
+		return;
+	smp_rmb();
+	__flush_tlb_kernel_range(flush_va_start, flush_va_end);
+	clear_bit(cpu, &flush_cpumask);
+}
+
+/*
+ * Run the function asked for, if it is for us; like do_flush_tlb(),
+ * from the IPI or from a wait loop on this CPU. Without @wait the
+ * request may be gone as soon as our bit is, so it is copied first.
+ */
+static void do_call_function(int cpu)
+{
+	struct call_data_struct *data;
+	void (*func) (void *info);
+	void *info;
+	unsigned long flags;
+
+	if (!test_bit(cpu, &call_cpumask))
+		return;
+	smp_rmb();
+	data = call_data;
+	func = data->func;
+	info = data->info;
+
+	local_irq_save(flags);
+	if (data->wait) {
+		(*func)(info);
+		smp_mb();
+		clear_bit(cpu, &call_cpumask);
+	} else {
+		smp_mb();
+		clear_bit(cpu, &call_cpumask);
+		(*func)(info);
+	}
+	local_irq_restore(flags);
+}
+
+/*
+ * Whatever the other CPUs want from us: a CPU waiting for the others
+ * with interrupts off calls this so that they don't wait for it too.
+ */
+static void smp_service_requests(int cpu)
+{
+	do_flush_tlb(cpu);
+	do_call_function(cpu);
+}
+
+/*
+ * INVALIDATE_TLB_VECTOR, from invalidate_interrupt in entry.S with
+ * interrupts off.
+ */
+asmlinkage void smp_invalidate_interrupt(void)
+{
+	ack_APIC_irq();
+	do_flush_tlb(smp_processor_id());
+}
+
+/* CALL_FUNCTION_VECTOR, from call_function_interrupt in entry.S */
+asmlinkage void smp_call_function_interrupt(void)
+{
+	ack_APIC_irq();
+	do_call_function(smp_processor_id());
+}
+
+/*
+ * Have the CPUs in @mask flush [start, end) and wait until they did.
+ * The waiting is done with our own interrupts in whatever state the
+ * caller left them, so while we wait for somebody else's request to
+ * finish we answer it ourselves. The caller must not hold a lock the
+ * other CPUs may spin on with interrupts off: they couldn't take the
+ * IPI.
+ */
+static void flush_tlb_others(unsigned long mask, unsigned long start,
+			     unsigned long end)
+{
+	int cpu = smp_processor_id();
+
+	if (!mask)
+		return;
+
+	while (!spin_trylock(&tlbstate_lock)) {
+		smp_service_requests(cpu);
+		cpu_relax();
+	}
+	flush_va_start = start;
+	flush_va_end = end;
+	/* the range must be visible before any bit is */
+	smp_mb();
+	flush_cpumask = mask;
+
+	send_IPI_mask(mask, INVALIDATE_TLB_VECTOR);
+
+	while (flush_cpumask) {
+		do_call_function(cpu);
+		cpu_relax();
+	}
+	spin_unlock(&tlbstate_lock);
+}
+
+/* every online CPU but this one */
+static inline unsigned long other_cpus(void)
+{
+	return cpu_online_map & ~(1UL << smp_processor_id());
+}
+
+void flush_tlb_kernel_range(unsigned long start, unsigned long end)
+{
+	__flush_tlb_kernel_range(start, end);
+	flush_tlb_others(other_cpus(), start, end);
+}
+
+/*
+ * Global entries too, and CR3 is reloaded everywhere: with PAE that
+ * is what makes a CPU read the pgd entries again.
+ */
+void flush_tlb_all(void)
+{
+	__flush_tlb_all();
+	flush_tlb_others(other_cpus(), 0, ~0UL);
+}
+
+/**
+ * smp_call_function - run a function on all other CPUs
+ * @func: the function to run, with interrupts off
+ * @info: its argument
+ * @wait: wait until @func has returned everywhere, not just started
+ *
+ * Returns 0. Like flush_tlb_others(), we may wait with interrupts off
+ * and answer the other CPUs' requests meanwhile, so the caller must
+ * not hold a lock those CPUs may spin on with interrupts off. @func
+ * must be quick and not call this again.
+ */
+int smp_call_function(void (*func) (void *info), void *info, int wait)
+{
+	struct call_data_struct data;
+	unsigned long mask;
+	int cpu = smp_processor_id();
+
+	mask = other_cpus();
+	if (!mask)
+		return 0;
+
+	data.func = func;
+	data.info = info;
+	data.wait = wait;
+
+	while (!spin_trylock(&call_lock)) {
+		smp_service_requests(cpu);
+		cpu_relax();
+	}
+	call_data = &data;
+	/* the request must be visible before any bit is */
+	smp_mb();
+	call_cpumask = mask;
+
+	send_IPI_mask(mask, CALL_FUNCTION_VECTOR);
+
+	while (call_cpumask) {
+		do_flush_tlb(cpu);
+		cpu_relax();
+	}
+	spin_unlock(&call_lock);
+	return 0;
+}
+
+void __init smp_intr_init(void)
+{
+	set_intr_gate(INVALIDATE_TLB_VECTOR, invalidate_interrupt);
+	set_intr_gate(CALL_FUNCTION_VECTOR, call_function_interrupt);
+}
+
+#endif /* CONFIG_SMP */
@@ -0,0 +1,333 @@
+/*
+ *	x86 SMP booting functions
+ *
+ *	(c) 1995 Alan Cox, Building #3 <alan@redhat.com>
+ *	(c) 1998, 1999, 2000 Ingo Molnar <mingo@redhat.com>
+ *
+ *	Much of the core SMP work is based on previous work by Thomas Radke, to
+ *	whom a great many thanks are extended.
+ *
+ *	Thanks to Intel for making available several different Pentium,
+ *	Pentium Pro and Pentium-II/Xeon MP machines.
+ *	Original development of Linux SMP code supported by Caldera.
+ *
+ *	The boot CPU finds the others in the MADT or the MP table and
+ *	wakes them one at a time with INIT, STARTUP, STARTUP from its
+ *	local APIC. Each gets a stack, and a GDT of its own whose PDA
+ *	entry tells it its CPU number (see asm/pda.h). The only IPI is
+ *	the TLB flush (smp.c) and there is nothing to schedule yet: once
+ *	up, an AP sits in cpu_idle(), zeroing free pages ahead of time
+ *	and halting.
+ */
+
+#include <linux/delay.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/linkage.h>
+#include <linux/mm.h>
+#include <linux/smp.h>
+#include <linux/string.h>
+#include <asm/apic.h>
+#include <asm/bitops.h>
+#include <asm/desc.h>
+#include <asm/gdt.h>
+#include <asm/io.h>
+#include <asm/mpspec.h>
+#include <asm/pda.h>
+#include <asm/processor.h>
+#include <asm/segment.h>
+#include <asm/stdio.h>
+#include <asm/system.h>
+
+#ifdef CONFIG_SMP
+
+extern void cpu_idle(void);
+
+/* Total count of live CPUs */
+int smp_num_cpus = 1;
+
+/* Bitmask of currently online CPUs */
+volatile unsigned long cpu_online_map;
+
+/* which logical CPU number maps to which local APIC ID */
+int x86_cpu_to_apicid[NR_CPUS];
+
+struct i386_pda cpu_pda[NR_CPUS];
+
+static struct desc_struct cpu_gdt_table[NR_CPUS][GDT_ENTRIES]
+	__attribute__((__aligned__(8)));
+static struct Xgt_desc_struct cpu_gdt_descr[NR_CPUS];
+
+/* the CPU the trampoline is starting, for start_secondary() */
+static volatile int booting_cpu;
+
+/*
+ * Whether the AP being started made it in time: it moves AP_BOOTING to
+ * AP_ONLINE, or the boot CPU gives up first and moves it to
+ * AP_ABANDONED. Only one of them can win.
+ */
+#define AP_BOOTING	1
+#define AP_ONLINE	2
+#define AP_ABANDONED	3
+static volatile int ap_boot_state;
+
+extern unsigned char trampoline_data[], trampoline_end[];
+extern unsigned long trampoline_cr3, trampoline_cr4;
+extern unsigned long trampoline_esp, trampoline_entry;
+
+/*
+ * Copy boot.c's GDT for @cpu and add the PDA segment over cpu_pda[cpu].
+ * The segment is byte granular: an offset past the struct faults.
+ */
+static void cpu_gdt_init(int cpu)
+{
+	struct desc_struct *gdt = cpu_gdt_table[cpu];
+	unsigned long base = (unsigned long)&cpu_pda[cpu];
+	unsigned long limit = sizeof(struct i386_pda) - 1;
+
+	memcpy(gdt, gdt_table, 6 * sizeof(struct desc_struct));
+	/* present, DPL 0, read/write data, 32-bit */
+	gdt[GDT_ENTRY_KERNEL_PDA].a = ((base & 0xffff) << 16) | (limit & 0xffff);
+	gdt[GDT_ENTRY_KERNEL_PDA].b = (base & 0xff000000) |
+		((base >> 16) & 0xff) | (limit & 0xf0000) | 0x00409200;
+
+	cpu_gdt_descr[cpu].size = GDT_ENTRIES * 8 - 1;
+	cpu_gdt_descr[cpu].address = (unsigned long)gdt;
+
+	cpu_pda[cpu]._pda = &cpu_pda[cpu];
+	cpu_pda[cpu].cpu_number = cpu;
+}
+
+/* Switch to @cpu's GDT and reload every segment register from it */
+static void cpu_gdt_load(int cpu)
+{
+	__asm__ __volatile__("lgdt %0" : : "m" (cpu_gdt_descr[cpu]));
+	__asm__ __volatile__(
+		"ljmp %0,$1f\n"
+		"1:\t"
+		"movl %1,%%eax\n\t"
+		"movl %%eax,%%ds\n\t"
+		"movl %%eax,%%es\n\t"
+		"movl %%eax,%%ss\n\t"
+		"movl %2,%%eax\n\t"
+		"movl %%eax,%%fs\n\t"
+		"movl %3,%%eax\n\t"
+		"movl %%eax,%%gs"
+		: : "i" (__KERNEL_CS), "i" (__KERNEL_DS),
+		    "i" (__KERNEL_PDA), "i" (SELECTOR_K_GS)
+		: "eax", "memory");
+}
+
+/*
+ * The boot CPU moves to its own GDT before anything can ask for
+ * smp_processor_id(): first thing in start_kernel().
+ */
+void __init smp_prepare_boot_cpu(void)
+{
+	cpu_gdt_init(0);
+	cpu_gdt_load(0);
+	set_bit(0, &cpu_online_map);
+}
+
+/*
+ * Everything an AP does before it reports in runs from .text.init,
+ * which only stays mapped as long as the boot CPU waits for it.
+ */
+static void __init smp_callin(int cpu)
+{
+	cpu_gdt_load(cpu);
+	__asm__ __volatile__("lidt %0" : : "m" (idt_descr));
+	cpu_init();
+	setup_local_APIC();
+}
+
+/*
+ * Activate a secondary processor, called by the trampoline on the
+ * stack do_boot_cpu() gave it. Not __init: as soon as our bit is in
+ * cpu_online_map the boot CPU goes on and may zap the low mappings.
+ */
+asmlinkage void start_secondary(void)
+{
+	int cpu = booting_cpu;
+
+	smp_callin(cpu);
+	if (cmpxchg(&ap_boot_state, AP_BOOTING, AP_ONLINE) != AP_BOOTING) {
+		/* too late, the boot CPU has given up on us and INITs us */
+		for (;;)
+			__asm__ __volatile__("cli; hlt");
+	}
+	set_bit(cpu, &cpu_online_map);
+	/* nothing but TLB flush IPIs come in, they mustn't wait on us */
+	local_irq_enable();
+	cpu_idle();
+}
+
+static int __init apic_wait_icr_idle(void)
+{
+	int timeout = 1000;
+
+	while ((apic_read(APIC_ICR) & APIC_ICR_BUSY) && --timeout)
+		udelay(100);
+	return !timeout;
+}
+
+/*
+ * INIT asserted and deasserted: whatever the target was doing, it is
+ * now waiting for a STARTUP.
+ */
+static int __init send_INIT(int phys_apicid)
+{
+	int send_status;
+
+	/*
+	 * Turn INIT on target chip
+	 */
+	apic_write(APIC_ICR2, SET_APIC_DEST_FIELD(phys_apicid));
+	apic_write(APIC_ICR, APIC_INT_LEVELTRIG | APIC_INT_ASSERT | APIC_DM_INIT);
+	send_status = apic_wait_icr_idle();
+
+	mdelay(10);
+
+	apic_write(APIC_ICR2, SET_APIC_DEST_FIELD(phys_apicid));
+	apic_write(APIC_ICR, APIC_INT_LEVELTRIG | APIC_DM_INIT);
+	send_status |= apic_wait_icr_idle();
+	return send_status;
+}
+
+/*
+ * The universal startup algorithm of the MP specification: INIT
+ * asserted and deasserted, then STARTUP twice. The STARTUP vector is
+ * the page the AP starts executing at, in real mode.
+ */
+static int __init wakeup_secondary_via_INIT(int phys_apicid,
+					    unsigned long start_eip)
+{
+	int send_status, j;
+
+	send_status = send_INIT(phys_apicid);
+
+	/*
+	 * Run STARTUP IPI loop.
+	 */
+	for (j = 1; !send_status && j <= 2; j++) {
+		apic_write(APIC_ICR2, SET_APIC_DEST_FIELD(phys_apicid));
+		apic_write(APIC_ICR, APIC_DM_STARTUP | (start_eip >> 12));
+
+		/*
+		 * Give the other CPU some time to accept the IPI.
+		 */
+		udelay(300);
+		send_status = apic_wait_icr_idle();
+		udelay(200);
+	}
+
+	return send_status;
+}
+
+static int __init do_boot_cpu(int apicid, int cpu)
+{
+	unsigned long stack;
+	int timeout;
+
+	/* two pages, like a 2.4 task's kernel stack */
+	stack = __get_free_pages(GFP_KERNEL, 1);
+	if (!stack)
+		return -1;
+
+	cpu_gdt_init(cpu);
+	cpu_pda[cpu].apicid = apicid;
+	x86_cpu_to_apicid[cpu] = apicid;
+	booting_cpu = cpu;
+	ap_boot_state = AP_BOOTING;
+
+	trampoline_esp = stack + 2 * PAGE_SIZE;
+	memcpy(phys_to_virt(TRAMPOLINE_BASE), trampoline_data,
+	       trampoline_end - trampoline_data);
+
+	printk("Booting processor %d/%d\n", cpu, apicid);
+	if (wakeup_secondary_via_INIT(apicid, TRAMPOLINE_BASE)) {
+		printk(KERN_ERR "APIC never delivered???\n");
+		goto abandon;
+	}
+
+	/*
+	 * Wait 5s total for the AP to report in
+	 */
+	for (timeout = 0; timeout < 50000; timeout++) {
+		if (test_bit(cpu, &cpu_online_map))
+			return 0;
+		udelay(100);
+	}
+	printk(KERN_ERR "CPU%d (APIC %d) not responding.\n", cpu, apicid);
+
+abandon:
+	/* it got in right at the end, its bit is on the way */
+	if (cmpxchg(&ap_boot_state, AP_BOOTING, AP_ABANDONED) != AP_BOOTING) {
+		while (!test_bit(cpu, &cpu_online_map))
+			cpu_relax();
+		return 0;
+	}
+	/*
+	 * The AP may still be on its way, in the trampoline or in __init
+	 * code on the low mappings, using the stack and the GDT of this
+	 * slot. INIT stops it wherever it is; after that the slot, the
+	 * stack and the trampoline can all be used for the next AP.
+	 */
+	if (send_INIT(apicid)) {
+		/* we can't tell where it is, leave it everything it has */
+		printk(KERN_ERR "CPU%d (APIC %d) won't take INIT, giving up "
+		       "on the others.\n", cpu, apicid);
+		return -2;
+	}
+	free_pages(stack, 1);
+	return -1;
+}
+
+/*
+ * Bring up every processor the firmware lists. Must run before
+ * zap_low_mappings(): the trampoline turns paging on while running
+ * from the identity mapping, and the APs run __init code on their way
+ * up. When we return no AP is still starting: each one is online or
+ * was stopped with INIT.
+ */
+void __init smp_boot_cpus(void)
+{
+	int boot_apicid, apicid, cpu, i, ret;
+
+	boot_apicid = apic_base ? hard_smp_processor_id() : 0;
+	x86_cpu_to_apicid[0] = boot_apicid;
+	cpu_pda[0].apicid = boot_apicid;
+
+	if (!smp_found_config) {
+		printk(KERN_NOTICE "SMP motherboard not detected.\n");
+		return;
+	}
+	if (!apic_base) {
+		printk(KERN_NOTICE "Local APIC not usable, using one CPU.\n");
+		return;
+	}
+	get_smp_config();
+	smp_intr_init();
+
+	__asm__ __volatile__("movl %%cr3,%0" : "=r" (trampoline_cr3));
+	/* anything with a local APIC has a CR4 */
+	trampoline_cr4 = read_cr4();
+	trampoline_entry = (unsigned long)start_secondary;
+
+	cpu = 1;
+	for (i = 0; i < num_processors && cpu < NR_CPUS; i++) {
+		apicid = bios_cpu_apicid[i];
+		if (apicid == boot_apicid)
+			continue;
+		ret = do_boot_cpu(apicid, cpu);
+		if (!ret)
+			cpu++;
+		else if (ret == -2)
+			break;
+	}
+	smp_num_cpus = cpu;
+
+	printk("Total of %d processors activated.\n", smp_num_cpus);
+}
+
+#endif /* CONFIG_SMP */
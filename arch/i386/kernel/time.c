@@ -0,0 +1,127 @@
+/*
+ *  linux/arch/i386/kernel/time.c
+ *
+ *  Copyright (C) 1991, 1992, 1995  Linus Torvalds
+ *
+ *  The 8253/8254 PIT: channel 0 is a clock event device on IRQ0,
+ *  channel 2 (the speaker's) times the TSC and local APIC timer
+ *  calibrations, which need no interrupts.
+ */
+
+#include <linux/clockchips.h>
+#include <linux/init.h>
+#include <linux/interrupt.h>
+#include <linux/jiffies.h>
+#include <linux/timer.h>
+#include <asm/apic.h>
+#include <asm/io.h>
+#include <asm/system.h>
+#include <asm/timer.h>
+
+#define PIT_MODE	0x43
+#define PIT_CH0		0x40
+#define PIT_CH2		0x42
+
+/*
+ * Initialize the PIT timer.
+ */
+static void init_pit_timer(enum clock_event_mode mode,
+			   struct clock_event_device *evt)
+{
+	switch(mode) {
+	case CLOCK_EVT_MODE_PERIODIC:
+		/* binary, mode 2, LSB/MSB, ch 0 */
+		outb_p(0x34, PIT_MODE);
+		outb_p(LATCH & 0xff , PIT_CH0);	/* LSB */
+		outb(LATCH >> 8 , PIT_CH0);	/* MSB */
+		break;
+
+	case CLOCK_EVT_MODE_SHUTDOWN:
+	case CLOCK_EVT_MODE_UNUSED:
+	case CLOCK_EVT_MODE_ONESHOT:
+		/*
+		 * binary, mode 0, LSB/MSB, ch 0: the counter waits for a
+		 * count before it starts, then interrupts once at zero
+		 */
+		outb_p(0x30, PIT_MODE);
+		break;
+	}
+}
+
+/*
+ * Program the next event in oneshot mode
+ *
+ * Delta is given in PIT ticks
+ */
+static int pit_next_event(unsigned long delta, struct clock_event_device *evt)
+{
+	outb_p(delta & 0xff , PIT_CH0);	/* LSB */
+	outb(delta >> 8 , PIT_CH0);	/* MSB */
+	return 0;
+}
+
+/*
+ * On UP the PIT can serve all of the possible timer functions. On SMP systems
+ * it can be solely used for the global tick. The local APIC timer is
+ * rated better, and takes over when there is one.
+ */
+static struct clock_event_device pit_clockevent = {
+	.name		= "pit",
+	.features	= CLOCK_EVT_FEAT_PERIODIC | CLOCK_EVT_FEAT_ONESHOT,
+	.set_mode	= init_pit_timer,
+	.set_next_event = pit_next_event,
+	.shift		= 32,
+	.rating		= 50,
+};
+
+/*
+ * timer_interrupt() needs to keep up the real-time clock,
+ * as well as call the "do_timer()" routine every clocktick
+ */
+static irqreturn_t timer_interrupt(int irq, void *dev_id)
+{
+	pit_clockevent.event_handler(&pit_clockevent);
+	return IRQ_HANDLED;
+}
+
+static struct irqaction irq0  = { timer_interrupt, 0, "timer", NULL, NULL };
+
+/*
+ * Start PIT channel 2 counting down @ms milliseconds, with the speaker
+ * gated off. pit_calibrate_done() turns true when it reaches zero.
+ */
+void __init pit_calibrate_start(unsigned long ms)
+{
+	unsigned long latch = CLOCK_TICK_RATE * ms / 1000;
+
+	/* Set the Gate high, disable speaker */
+	outb((inb(0x61) & ~0x02) | 0x01, 0x61);
+
+	outb(0xb0, PIT_MODE);			/* binary, mode 0, LSB/MSB, Ch 2 */
+	outb(latch & 0xff, PIT_CH2);	/* LSB of count */
+	outb(latch >> 8, PIT_CH2);	/* MSB of count */
+}
+
+int __init pit_calibrate_done(void)
+{
+	return inb(0x61) & 0x20;
+}
+
+void __init time_init(void)
+{
+	init_timervecs();
+	tsc_init();
+
+	/* 0x7FFF: some of the PIT clones are unreliable above that */
+	pit_clockevent.mult = div_sc(CLOCK_TICK_RATE, NSEC_PER_SEC,
+				     pit_clockevent.shift);
+	pit_clockevent.max_delta_ns =
+		clockevent_delta2ns(0x7FFF, &pit_clockevent);
+	pit_clockevent.min_delta_ns =
+		clockevent_delta2ns(0xF, &pit_clockevent);
+
+	setup_irq(0, &irq0);
+	clockevents_register_device(&pit_clockevent);
+
+	setup_boot_APIC_clock();
+}
@@ -0,0 +1,180 @@
+/*
+ *  linux/arch/i386/traps.c
+ *
+ *  Copyright (C) 1991, 1992  Linus Torvalds
+ *
+ *  Pentium III FXSR, SSE support
+ *	Gareth Hughes <gareth@valinux.com>, May 2000
+ */
+
+/*
+ * 'Traps.c' handles hardware traps and faults after we have saved some
+ * state in 'entry.S'. There is no user mode yet, so any exception is
+ * a kernel bug: it is reported with the registers and ends in
+ * panic_spin().
+ */
+
+#include <linux/debug.h>
+#include <linux/init.h>
+#include <linux/interrupt.h>
+#include <linux/kernel.h>
+#include <linux/linkage.h>
+#include <asm/desc.h>
+#include <asm/io.h>
+#include <asm/ptrace.h>
+#include <asm/segment.h>
+#include <asm/stdio.h>
+
+// 256 个门共 2KB，按 8 字节对齐
+struct desc_struct idt_table[IDT_ENTRIES] __attribute__((__aligned__(8)));
+
+struct Xgt_desc_struct idt_descr = {
+	IDT_ENTRIES * 8 - 1, (unsigned long)idt_table
+};
+
+asmlinkage void divide_error(void);
+asmlinkage void debug(void);
+asmlinkage void nmi(void);
+asmlinkage void int3(void);
+asmlinkage void overflow(void);
+asmlinkage void bounds(void);
+asmlinkage void invalid_op(void);
+asmlinkage void device_not_available(void);
+asmlinkage void double_fault(void);
+asmlinkage void coprocessor_segment_overrun(void);
+asmlinkage void invalid_TSS(void);
+asmlinkage void segment_not_present(void);
+asmlinkage void stack_segment(void);
+asmlinkage void general_protection(void);
+asmlinkage void page_fault(void);
+asmlinkage void coprocessor_error(void);
+asmlinkage void simd_coprocessor_error(void);
+asmlinkage void alignment_check(void);
+asmlinkage void spurious_interrupt_bug(void);
+asmlinkage void machine_check(void);
+
+static void show_registers(struct pt_regs *regs)
+{
+	/* from kernel mode the CPU doesn't push esp/ss */
+	unsigned long esp = (unsigned long)&regs->esp;
+	unsigned long cr2;
+
+	__asm__("movl %%cr2,%0" : "=r" (cr2));
+	printk("EIP:    %04x:[<%08lx>]\n", 0xffff & regs->xcs, regs->eip);
+	printk("EFLAGS: %08lx\n", regs->eflags);
+	printk("eax: %08lx   ebx: %08lx   ecx: %08lx   edx: %08lx\n",
+		regs->eax, regs->ebx, regs->ecx, regs->edx);
+	printk("esi: %08lx   edi: %08lx   ebp: %08lx   esp: %08lx\n",
+		regs->esi, regs->edi, regs->ebp, esp);
+	printk("ds: %04x   es: %04x   cr2: %08lx\n",
+		regs->xds & 0xffff, regs->xes & 0xffff, cr2);
+}
+
+void die(const char *str, struct pt_regs *regs, long err)
+{
+	printk(KERN_EMERG "%s: %04lx\n", str, err & 0xffff);
+	show_registers(regs);
+	panic_spin(__FILE__, __LINE__, str);
+}
+
+#define DO_ERROR(trapnr, str, name) \
+asmlinkage void do_##name(struct pt_regs *regs, long error_code) \
+{ \
+	die(str, regs, error_code); \
+}
+
+DO_ERROR( 0, "divide error", divide_error)
+DO_ERROR( 1, "debug", debug)
+DO_ERROR( 3, "int3", int3)
+DO_ERROR( 4, "overflow", overflow)
+DO_ERROR( 5, "bounds", bounds)
+DO_ERROR( 6, "invalid operand", invalid_op)
+DO_ERROR( 7, "device not available", device_not_available)
+DO_ERROR( 8, "double fault", double_fault)
+DO_ERROR( 9, "coprocessor segment overrun", coprocessor_segment_overrun)
+DO_ERROR(10, "invalid TSS", invalid_TSS)
+DO_ERROR(11, "segment not present", segment_not_present)
+DO_ERROR(12, "stack segment", stack_segment)
+DO_ERROR(13, "general protection", general_protection)
+DO_ERROR(16, "coprocessor error", coprocessor_error)
+DO_ERROR(17, "alignment check", alignment_check)
+DO_ERROR(18, "machine check", machine_check)
+DO_ERROR(19, "simd coprocessor error", simd_coprocessor_error)
+
+/* An NMI is reported, but isn't fatal: the hardware tells us, we carry on */
+asmlinkage void do_nmi(struct pt_regs *regs, long error_code)
+{
+	unsigned char reason = inb(0x61);
+
+	printk(KERN_EMERG "Uhhuh. NMI received for unknown reason %02x.\n",
+	       reason);
+	printk("Dazed and confused, but trying to continue\n");
+}
+
+asmlinkage void do_spurious_interrupt_bug(struct pt_regs *regs,
+					  long error_code)
+{
+}
+
+#define _set_gate(gate_addr,type,dpl,addr) \
+do { \
+  int __d0, __d1; \
+  __asm__ __volatile__ ("movw %%dx,%%ax\n\t" \
+	"movw %4,%%dx\n\t" \
+	"movl %%eax,%0\n\t" \
+	"movl %%edx,%1" \
+	:"=m" (*((long *) (gate_addr))), \
+	 "=m" (*(1+(long *) (gate_addr))), "=&a" (__d0), "=&d" (__d1) \
+	:"i" ((short) (0x8000+(dpl<<13)+(type<<8))), \
+	 "3" ((char *) (addr)),"2" (__KERNEL_CS << 16)); \
+} while (0)
+
+/*
+ * Interrupt gates clear IF on entry, trap gates leave it alone. A
+ * system gate can be used with "int" from user mode.
+ */
+void set_intr_gate(unsigned int n, void *addr)
+{
+	_set_gate(idt_table+n,14,0,addr);
+}
+
+void set_trap_gate(unsigned int n, void *addr)
+{
+	_set_gate(idt_table+n,15,0,addr);
+}
+
+void set_system_gate(unsigned int n, void *addr)
+{
+	_set_gate(idt_table+n,15,3,addr);
+}
+
+/*
+ * The exceptions. The vectors from FIRST_EXTERNAL_VECTOR on are
+ * init_IRQ()'s, everything else stays not present: an int to one of
+ * them ends up in segment_not_present.
+ */
+void __init trap_init(void)
+{
+	set_trap_gate(0,&divide_error);
+	set_intr_gate(1,&debug);
+	set_intr_gate(2,&nmi);
+	set_system_gate(3,&int3);	/* int3-5 can be called from all */
+	set_system_gate(4,&overflow);
+	set_system_gate(5,&bounds);
+	set_trap_gate(6,&invalid_op);
+	set_trap_gate(7,&device_not_available);
+	set_trap_gate(8,&double_fault);
+	set_trap_gate(9,&coprocessor_segment_overrun);
+	set_trap_gate(10,&invalid_TSS);
+	set_trap_gate(11,&segment_not_present);
+	set_trap_gate(12,&stack_segment);
+	set_trap_gate(13,&general_protection);
+	set_intr_gate(14,&page_fault);
+	set_trap_gate(15,&spurious_interrupt_bug);
+	set_trap_gate(16,&coprocessor_error);
+	set_trap_gate(17,&alignment_check);
+	set_trap_gate(18,&machine_check);
+	set_trap_gate(19,&simd_coprocessor_error);
+
+	__asm__ __volatile__("lidt %0" : : "m" (idt_descr));
+}
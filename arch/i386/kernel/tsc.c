@@ -0,0 +1,75 @@
+/*
+ *  linux/arch/i386/kernel/tsc.c
+ *
+ *  The TSC as the clocksource. Its rate is measured against the PIT
+ *  once at boot and it is never read from the PIT again: reading the
+ *  PIT's counter is several port accesses, each a VM exit under a
+ *  hypervisor, rdtsc normally isn't.
+ */
+
+#include <linux/clocksource.h>
+#include <linux/init.h>
+#include <linux/jiffies.h>
+#include <asm/div64.h>
+#include <asm/processor.h>
+#include <asm/stdio.h>
+#include <asm/timer.h>
+
+#define CALIBRATE_MS	50
+
+unsigned long cpu_khz;	/* Detected as we calibrate the TSC */
+
+/*
+ * Time the TSC over CALIBRATE_MS of PIT channel 2 and return its rate
+ * in kHz, or 0 if the PIT never seemed to count.
+ */
+static unsigned long __init calibrate_tsc(void)
+{
+	unsigned long long start, end;
+	unsigned long count = 0;
+
+	pit_calibrate_start(CALIBRATE_MS);
+	rdtscll(start);
+	do {
+		count++;
+	} while (!pit_calibrate_done());
+	rdtscll(end);
+
+	/* Error: ECTCNEVERSET */
+	if (count <= 1)
+		return 0;
+
+	end -= start;
+	do_div(end, CALIBRATE_MS);
+	return (unsigned long) end;
+}
+
+static cycle_t read_tsc(void)
+{
+	return get_cycles();
+}
+
+static struct clocksource clocksource_tsc = {
+	.name			= "tsc",
+	.rating			= 300,
+	.read			= read_tsc,
+	.shift			= 22,
+};
+
+void __init tsc_init(void)
+{
+	if (!cpu_has_tsc)
+		return;
+
+	cpu_khz = calibrate_tsc();
+	if (!cpu_khz) {
+		printk("TSC calibration failed, no clocksource.\n");
+		return;
+	}
+	printk("Detected %lu.%03lu MHz processor.\n",
+	       cpu_khz / 1000, cpu_khz % 1000);
+
+	clocksource_tsc.mult = clocksource_khz2mult(cpu_khz,
+						    clocksource_tsc.shift);
+	clocksource_register(&clocksource_tsc);
+}
@@ -0,0 +1,38 @@
+/*
+ *	Precise Delay Loops for i386
+ *
+ *	Copyright (C) 1993 Linus Torvalds
+ *	Copyright (C) 1997 Martin Mares <mj@atrey.karlin.mff.cuni.cz>
+ *
+ *	The TSC is calibrated by tsc_init(), delays count its cycles.
+ *	Before that, or without a TSC, each microsecond is a read from
+ *	port 0x80, which takes about that long on the ISA bus.
+ */
+
+#include <asm/delay.h>
+#include <asm/div64.h>
+#include <asm/io.h>
+#include <asm/processor.h>
+#include <asm/timex.h>
+
+static void delay_tsc(unsigned long long cycles)
+{
+	cycles_t start = get_cycles();
+
+	while (get_cycles() - start < cycles)
+		rep_nop();
+}
+
+void __udelay(unsigned long usecs)
+{
+	unsigned long long cycles;
+
+	if (!cpu_khz) {
+		while (usecs--)
+			inb(0x80);
+		return;
+	}
+	cycles = (unsigned long long) usecs * cpu_khz;
+	do_div(cycles, 1000);
+	delay_tsc(cycles);
+}
@@ -0,0 +1,69 @@
+/*
+ *  linux/arch/i386/lib/page.c
+ *
+ *  Whole-page clearing. The variant is picked once at boot from the
+ *  CPU features, clear_page() goes through the pointer.
+ */
+
+#include <linux/init.h>
+#include <asm/page.h>
+#include <asm/processor.h>
+#include <asm/stdio.h>
+
+/*
+ * rep stosl works on anything from a 386 up and on newer parts is
+ * turned into full cache line writes by the microcode.
+ */
+static void stosl_clear_page(void *page)
+{
+	int d0, d1;
+
+	__asm__ __volatile__(
+		"cld\n\t"
+		"rep ; stosl"
+		: "=&c" (d0), "=&D" (d1)
+		: "a" (0), "0" (PAGE_SIZE / 4), "1" (page)
+		: "memory");
+}
+
+/*
+ * SSE2 non-temporal stores: the zeroes go straight to memory without
+ * pulling the page into the cache first, and without evicting whatever
+ * the caller is working on. movnti only uses general registers, so no
+ * FPU/XMM state is touched. The sfence orders the weakly ordered
+ * stores before anyone else looks at the page.
+ */
+static void movnti_clear_page(void *page)
+{
+	int d0, d1;
+
+	__asm__ __volatile__(
+		"1:\tmovnti %%eax,(%1)\n\t"
+		"movnti %%eax,4(%1)\n\t"
+		"movnti %%eax,8(%1)\n\t"
+		"movnti %%eax,12(%1)\n\t"
+		"movnti %%eax,16(%1)\n\t"
+		"movnti %%eax,20(%1)\n\t"
+		"movnti %%eax,24(%1)\n\t"
+		"movnti %%eax,28(%1)\n\t"
+		"addl $32,%1\n\t"
+		"decl %0\n\t"
+		"jnz 1b\n\t"
+		"sfence"
+		: "=&r" (d0), "=&r" (d1)
+		: "a" (0), "0" (PAGE_SIZE / 32), "1" (page)
+		: "memory");
+}
+
+// 启动时由 clear_page_init() 根据 CPU 特性选定
+void (*__clear_page)(void *page) = stosl_clear_page;
+
+void __init clear_page_init(void)
+{
+	if (cpu_has_xmm2) {
+		__clear_page = movnti_clear_page;
+		printk("clear_page: using SSE2 non-temporal stores\n");
+	} else {
+		printk("clear_page: using rep stosl\n");
+	}
+}
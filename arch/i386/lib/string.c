@@ -1,30 +1,222 @@
 #include <asm/types.h>
-#include <linux/debug.h>
+#include <linux/init.h>
+#include <asm/processor.h>
+#include <asm/xmm.h>
+
+/*
+ * The bulk of every copy or fill goes through rep movsl/stosl on a
+ * 4-byte aligned destination, the string scans read an aligned word at
+ * a time (an aligned load never crosses into the next page, so reading
+ * past the terminator is safe). Below SMALL_BYTES a plain loop beats
+ * the rep startup cost.
+ *
+ * From STRING_SSE2_BYTES up, memcmp uses a 16-byte SSE2 loop when
+ * string_init() found SSE2, and so do memset/memcpy unless the CPU has
+ * ERMS: with fast string microcode rep stosl/movsl already write whole
+ * cache lines and beat the SSE2 loops (see bench/bench_string.c). The
+ * exception is a memcpy whose source and destination can't both be
+ * word aligned, rep movsl is slow then too.
+ *
+ * The SSE2 loops save the XMM registers they use and put them back,
+ * they may have interrupted another one (see asm/xmm.h).
+ */
+
+#define SMALL_BYTES 32
+/* Below this many bytes setting up the SSE2 loop doesn't pay off */
+#define STRING_SSE2_BYTES 512
+
+/* aligned word loads of byte data */
+typedef uint32_t __attribute__((__may_alias__)) word_t;
+
+#define ONES  0x01010101UL
+#define HIGHS 0x80808080UL
+/* non-zero if one of the four bytes of x is zero */
+#define HAS_ZERO(x) (((x) - ONES) & ~(x) & HIGHS)
+
+// 在 cpu_init() 打开 SSE 之后由 string_init() 设置
+static int sse2, fast_strings;
+
+void __init string_init(void) {
+   sse2 = cpu_has_xmm2;
+   fast_strings = cpu_has_erms;
+}
+
+/* rep stosl for the bulk, then the last 0-3 bytes */
+static inline void rep_stos(void* dst, uint32_t fill, uint32_t size) {
+   int d0, d1;
+   __asm__ __volatile__(
+      "rep ; stosl\n\t"
+      "testb $2,%b3\n\t"
+      "je 1f\n\t"
+      "stosw\n"
+      "1:\ttestb $1,%b3\n\t"
+      "je 2f\n\t"
+      "stosb\n"
+      "2:"
+      : "=&c" (d0), "=&D" (d1)
+      : "a" (fill), "q" (size), "0" (size / 4), "1" (dst)
+      : "memory");
+}
+
+static inline void rep_movs(void* dst, const void* src, uint32_t size) {
+   int d0, d1, d2;
+   __asm__ __volatile__(
+      "rep ; movsl\n\t"
+      "testb $2,%b4\n\t"
+      "je 1f\n\t"
+      "movsw\n"
+      "1:\ttestb $1,%b4\n\t"
+      "je 2f\n\t"
+      "movsb\n"
+      "2:"
+      : "=&c" (d0), "=&D" (d1), "=&S" (d2)
+      : "0" (size / 4), "q" (size), "1" (dst), "2" (src)
+      : "memory");
+}
+
+/* size >= STRING_SSE2_BYTES: align dst to 16, then 64 bytes per loop */
+static void sse2_memset(char* dst, uint32_t fill, uint32_t size) {
+   uint32_t head = -(unsigned long)dst & 15;
+   struct xmm_save xmm;
+   int d0;
+
+   rep_stos(dst, fill, head);
+   dst += head;
+   size -= head;
+   kernel_xmm_begin(&xmm, 1);
+   __asm__ __volatile__(
+      "movd %4, %%xmm0\n\t"
+      "pshufd $0, %%xmm0, %%xmm0\n"
+      "1:\tmovdqa %%xmm0, (%0)\n\t"
+      "movdqa %%xmm0, 16(%0)\n\t"
+      "movdqa %%xmm0, 32(%0)\n\t"
+      "movdqa %%xmm0, 48(%0)\n\t"
+      "addl $64, %0\n\t"
+      "decl %1\n\t"
+      "jnz 1b"
+      : "=r" (dst), "=r" (d0)
+      : "0" (dst), "1" (size / 64), "r" (fill)
+      : "memory");
+   kernel_xmm_end(&xmm, 1);
+   rep_stos(dst, fill, size & 63);
+}
+
+/* unaligned loads, aligned stores */
+static void sse2_memcpy(char* dst, const char* src, uint32_t size) {
+   uint32_t head = -(unsigned long)dst & 15;
+   struct xmm_save xmm;
+   int d0;
+
+   rep_movs(dst, src, head);
+   dst += head;
+   src += head;
+   size -= head;
+   kernel_xmm_begin(&xmm, 4);
+   __asm__ __volatile__(
+      "1:\tmovdqu (%1), %%xmm0\n\t"
+      "movdqu 16(%1), %%xmm1\n\t"
+      "movdqu 32(%1), %%xmm2\n\t"
+      "movdqu 48(%1), %%xmm3\n\t"
+      "movdqa %%xmm0, (%0)\n\t"
+      "movdqa %%xmm1, 16(%0)\n\t"
+      "movdqa %%xmm2, 32(%0)\n\t"
+      "movdqa %%xmm3, 48(%0)\n\t"
+      "addl $64, %0\n\t"
+      "addl $64, %1\n\t"
+      "decl %2\n\t"
+      "jnz 1b"
+      : "=r" (dst), "=r" (src), "=r" (d0)
+      : "0" (dst), "1" (src), "2" (size / 64)
+      : "memory");
+   kernel_xmm_end(&xmm, 4);
+   rep_movs(dst, src, size & 63);
+}
 
-void memset(void* dst_, uint8_t value, uint32_t size) {
-   if(dst_ == NULL) {
-       BUG();
+/*
+ * Skip the equal 16-byte blocks at the start of a and b, returns how
+ * many bytes that was (a multiple of 16, at most size).
+ */
+static uint32_t sse2_memcmp_skip(const char* a, const char* b, uint32_t size) {
+   const char* start = a;
+   struct xmm_save xmm;
+   int d0, mask;
+
+   kernel_xmm_begin(&xmm, 2);
+   __asm__ __volatile__(
+      "1:\tmovdqu (%1), %%xmm0\n\t"
+      "movdqu (%2), %%xmm1\n\t"
+      "pcmpeqb %%xmm1, %%xmm0\n\t"
+      "pmovmskb %%xmm0, %3\n\t"
+      "cmpl $0xffff, %3\n\t"
+      "jne 2f\n\t"
+      "addl $16, %1\n\t"
+      "addl $16, %2\n\t"
+      "decl %0\n\t"
+      "jnz 1b\n"
+      "2:"
+      : "=r" (d0), "=r" (a), "=r" (b), "=&r" (mask)
+      : "0" (size / 16), "1" (a), "2" (b)
+      : "memory", "cc");
+   kernel_xmm_end(&xmm, 2);
+   return a - start;
+}
+
+void* memset(void* dst_, uint8_t value, uint32_t size) {
+   char* dst = dst_;
+   if (size < SMALL_BYTES) {
+      for (; size >= 4; size -= 4, dst += 4)
+         *(word_t*)dst = value * ONES;
+      while (size-- > 0)
+         *dst++ = value;
+   } else if (size >= STRING_SSE2_BYTES && sse2 && !fast_strings) {
+      sse2_memset(dst, value * ONES, size);
+   } else {
+      // rep stosl 写不对齐的地址要慢好几倍，先逐字节对齐
+      while ((unsigned long)dst & 3) {
+         *dst++ = value;
+         size--;
+      }
+      rep_stos(dst, value * ONES, size);
    }
-   uint8_t* dst = (uint8_t*)dst_;
-   while (size-- > 0)
-      *dst++ = value;
+   return dst_;
 }
 
 void memcpy(void* dst_, const void* src_, uint32_t size) {
-   if(dst_ == NULL || src_ == NULL) {
-       BUG();
+   char* dst = dst_;
+   const char* src = src_;
+   if (size < SMALL_BYTES) {
+      // x86 不要求字访问对齐
+      for (; size >= 4; size -= 4, dst += 4, src += 4)
+         *(word_t*)dst = *(const word_t*)src;
+      while (size-- > 0)
+         *dst++ = *src++;
+   } else if (size >= STRING_SSE2_BYTES && sse2 &&
+              (!fast_strings || (((unsigned long)dst ^ (unsigned long)src) & 3))) {
+      // 源和目的地址没法同时对齐时 rep movsl 也很慢，SSE2 不在乎源地址对齐
+      sse2_memcpy(dst, src, size);
+   } else {
+      while ((unsigned long)dst & 3) {
+         *dst++ = *src++;
+         size--;
+      }
+      rep_movs(dst, src, size);
    }
-   uint8_t* dst = dst_;
-   const uint8_t* src = src_;
-   while (size-- > 0)
-      *dst++ = *src++;
 }
 
 int memcmp(const void* a_, const void* b_, uint32_t size) {
    const char* a = a_;
    const char* b = b_;
-   if(a == NULL || b == NULL) {
-       BUG();
+   if (size >= STRING_SSE2_BYTES && sse2) {
+      uint32_t same = sse2_memcmp_skip(a, b, size);
+      a += same;
+      b += same;
+      size -= same;
+   }
+   // 按字比较，找到不同的字后再逐字节确定大小
+   while (size >= 4 && *(const word_t*)a == *(const word_t*)b) {
+      a += 4;
+      b += 4;
+      size -= 4;
    }
    while (size-- > 0) {
       if(*a != *b) {
@@ -36,28 +228,38 @@ int memcmp(const void* a_, const void* b_, uint32_t size) {
    return 0;
 }
 
-char* strcpy(char* dst_, const char* src_) {
-   if(dst_ == NULL || src_ == NULL) {
-       BUG();
+uint32_t strlen(const char* str) {
+   const char* p = str;
+   const word_t* w;
+   while ((unsigned long)p & 3) {
+      if (*p == 0)
+         return p - str;
+      p++;
    }
-   char* r = dst_;
-   while((*dst_++ = *src_++));
-   return r;
+   for (w = (const word_t*)p; !HAS_ZERO(*w); w++)
+      ;
+   p = (const char*)w;
+   while (*p)
+      p++;
+   return p - str;
 }
 
-uint32_t strlen(const char* str) {
-   if(str == NULL) {
-       BUG();
+char* strcpy(char* dst_, const char* src_) {
+   char* dst = dst_;
+   const word_t* w;
+   while ((unsigned long)src_ & 3) {
+      if ((*dst++ = *src_++) == 0)
+         return dst_;
    }
-   const char* p = str;
-   while(*p++);
-   return (p - str - 1);
+   // 源字里没有结尾的 0 就整字复制
+   for (w = (const word_t*)src_; !HAS_ZERO(*w); w++, dst += 4)
+      *(word_t*)dst = *w;
+   src_ = (const char*)w;
+   while ((*dst++ = *src_++));
+   return dst_;
 }
 
 int8_t strcmp (const char* a, const char* b) {
-   if(a == NULL || b == NULL) {
-       BUG();
-   }
    while (*a != 0 && *a == *b) {
       a++;
       b++;
@@ -66,56 +268,50 @@ int8_t strcmp (const char* a, const char* b) {
 }
 
 char* strchr(const char* str, const uint8_t ch) {
-   if(str == NULL) {
-       BUG();
+   uint32_t pattern = ch * ONES;
+   const word_t* w;
+   while ((unsigned long)str & 3) {
+      if ((uint8_t)*str == ch)
+         return (char*)str;
+      if (*str == 0)
+         return NULL;
+      str++;
    }
+   // 一次检查四个字节：有没有结尾的 0，有没有 ch
+   for (w = (const word_t*)str; !HAS_ZERO(*w) && !HAS_ZERO(*w ^ pattern); w++)
+      ;
+   str = (const char*)w;
    while (*str != 0) {
-      if (*str == ch) {
-          return (char*)str;
-      }
+      if ((uint8_t)*str == ch)
+         return (char*)str;
       str++;
    }
-   return NULL;
+   return ch == 0 ? (char*)str : NULL;
 }
 
-
 char* strrchr(const char* str, const uint8_t ch) {
-   if(str == NULL) {
-       BUG();
-   }
    const char* last_char = NULL;
-
-   while (*str != 0) {
-      if (*str == ch) {
-	    last_char = str;
-      }
+   if (ch == 0)
+      return (char*)str + strlen(str);
+   while ((str = strchr(str, ch)) != NULL) {
+      last_char = str;
       str++;
    }
    return (char*)last_char;
 }
 
 char* strcat(char* dst_, const char* src_) {
-   if(dst_ == NULL || src_ == NULL) {
-       BUG();
-   }
-   char* str = dst_;
-   while (*str++);
-   --str;
-   while((*str++ = *src_++));
+   strcpy(dst_ + strlen(dst_), src_);
    return dst_;
 }
 
 uint32_t strchrs(const char* str, uint8_t ch) {
-   if(str == NULL) {
-       BUG();
-   }
    uint32_t ch_cnt = 0;
-   const char* p = str;
-   while(*p != 0) {
-      if (*p == ch) {
-	    ch_cnt++;
-      }
-      p++;
+   if (ch == 0)
+      return 0;
+   while ((str = strchr(str, ch)) != NULL) {
+      ch_cnt++;
+      str++;
    }
    return ch_cnt;
 }
@@ -203,41 +399,50 @@ char* uitoa(unsigned int num,char* dst,int radix)
     return dst;
 }
 
-uint32_t strnlen(const char* str, uint32_t max)
+int strncmp(const char * cs,const char * ct,size_t count)
 {
-    if(str == NULL) {
-        BUG();
+    register signed char __res = 0;
+
+    while (count) {
+        if ((__res = *cs - *ct++) != 0 || !*cs++)
+            break;
+        count--;
     }
-    uint32_t len = strlen(str);
-    return len >= max ? max : len;
+
+    return __res;
+}
+
+uint32_t strnlen(const char* str, uint32_t max) {
+   const char* p = str;
+   while (max && ((unsigned long)p & 3)) {
+      if (*p == 0)
+         return p - str;
+      p++;
+      max--;
+   }
+   while (max >= 4 && !HAS_ZERO(*(const word_t*)p)) {
+      p += 4;
+      max -= 4;
+   }
+   while (max && *p) {
+      p++;
+      max--;
+   }
+   return p - str;
 }
 
 char * strstr(const char * s1,const char * s2)
 {
-    int l1, l2;
+    int l2;
 
     l2 = strlen(s2);
     if (!l2)
         return (char *) s1;
-    l1 = strlen(s1);
-    while (l1 >= l2) {
-        l1--;
-        if (!memcmp(s1,s2,l2))
+    // 先用 strchr 找首字符，strncmp 遇到 s1 的结尾就停下
+    while ((s1 = strchr(s1, *s2)) != NULL) {
+        if (!strncmp(s1, s2, l2))
             return (char *) s1;
         s1++;
     }
     return NULL;
 }
-
-int strncmp(const char * cs,const char * ct,size_t count)
-{
-    register signed char __res = 0;
-
-    while (count) {
-        if ((__res = *cs - *ct++) != 0 || !*cs++)
-            break;
-        count--;
-    }
-
-    return __res;
-}
\ No newline at end of file
@@ -1,12 +1,402 @@
+/*
+ *  linux/arch/i386/mm/init.c
+ *
+ *  Copyright (C) 1995  Linus Torvalds
+ */
+
 #include <linux/init.h>
+#include <linux/mm.h>
+#include <linux/bootmem.h>
 #include <asm/stdio.h>
+#include <asm/pgtable.h>
+#include <asm/fixmap.h>
+#include <asm/dma.h>
+#include <asm/io.h>
+#include <asm/e820.h>
+#include <linux/debug.h>
+#include <linux/highmem.h>
+
+extern char _text, _etext, _edata, _end;
+
+pgd_t swapper_pg_dir[PTRS_PER_PGD] __attribute__((__aligned__(PAGE_SIZE)));
+
+unsigned long __PAGE_KERNEL = PAGE_PRESENT | PAGE_WRITE;
+
+#ifdef CONFIG_HIGHMEM
+unsigned long highstart_pfn, highend_pfn;
+unsigned long totalhigh_pages;
+
+pte_t *kmap_pte;
+pgprot_t kmap_prot;
+
+#define kmap_get_fixmap_pte(vaddr)					\
+	pte_offset(pmd_offset(pgd_offset_k(vaddr), (vaddr)), (vaddr))
+
+void __init kmap_init(void)
+{
+	unsigned long kmap_vstart;
+
+	/* cache the first kmap pte */
+	kmap_vstart = __fix_to_virt(FIX_KMAP_BEGIN);
+	kmap_pte = kmap_get_fixmap_pte(kmap_vstart);
+
+	kmap_prot = PAGE_KERNEL;
+	page_address_init();
+}
+#endif /* CONFIG_HIGHMEM */
+
+#ifdef CONFIG_X86_PAE
+/*
+ * boot.c turned paging on with two-level tables, and CR4.PAE can only
+ * change while paging is off. We run from the identity mapping here,
+ * but the stack is at its PAGE_OFFSET alias, so nothing between the
+ * two CR0 writes may touch memory: everything is in registers.
+ */
+static void __init enable_pae(pgd_t *pgdir)
+{
+	unsigned long cr0;
+
+	if (!cpu_has_pae) {
+		printk(KERN_EMERG "This kernel requires a CPU with PAE\n");
+		PANIC();
+	}
+	__asm__ __volatile__("movl %%cr0,%0" : "=r" (cr0));
+	mmu_cr4_features |= X86_CR4_PAE;
+	__asm__ __volatile__(
+		"movl %0, %%cr0\n\t"
+		"movl %1, %%cr4\n\t"
+		"movl %2, %%cr3\n\t"
+		"movl %3, %%cr0\n\t"
+		"jmp 1f\n"
+		"1:"
+		: /* no outputs */
+		: "r" (cr0 & ~X86_CR0_PG), "r" (read_cr4() | X86_CR4_PAE),
+		  "r" (__pa(pgdir)), "r" (cr0)
+		: "memory");
+}
+#endif
+
+/*
+ * Allocate the page tables (and with PAE the pmd pages) that cover
+ * [start, end), end == 0 meaning the top of the address space. The
+ * ptes themselves are filled in later, by kmap() and kmap_atomic().
+ */
+static void __init fixrange_init(unsigned long start, unsigned long end,
+	pgd_t *pgd_base)
+{
+	pgd_t *pgd;
+	pmd_t *pmd;
+	pte_t *pte;
+	int i, j;
+	unsigned long vaddr;
+
+	vaddr = start;
+	i = __pgd_offset(vaddr);
+	j = __pmd_offset(vaddr);
+	pgd = pgd_base + i;
+
+	for ( ; (i < PTRS_PER_PGD) && (vaddr != end); pgd++, i++) {
+#ifdef CONFIG_X86_PAE
+		if (pgd_none(*pgd)) {
+			pmd = (pmd_t *) alloc_bootmem_low_pages(PAGE_SIZE);
+			set_pgd(pgd, __pgd(__pa(pmd) | PAGE_PRESENT));
+			if (pmd != pmd_offset(pgd, 0))
+				BUG();
+		}
+		pmd = pmd_offset(pgd, vaddr);
+#else
+		pmd = (pmd_t *)pgd;
+#endif
+		for (; (j < PTRS_PER_PMD) && (vaddr != end); pmd++, j++) {
+			if (pmd_none(*pmd)) {
+				pte = (pte_t *) alloc_bootmem_low_pages(PAGE_SIZE);
+				set_pmd(pmd, __pmd(__pa(pte) | PAGE_PRESENT | PAGE_WRITE));
+				if (pte != pte_offset(pmd, 0))
+					BUG();
+			}
+			vaddr += PMD_SIZE;
+		}
+		j = 0;
+	}
+}
+
+/*
+ * Build the permanent kernel page tables: all of low memory is mapped
+ * at PAGE_OFFSET, with large pages (4MB, or 2MB with PAE) where the
+ * CPU has PSE and global entries where it has PGE, so the direct map
+ * costs one TLB entry per large page and survives CR3 reloads. A
+ * partial large page at the end of low memory, and everything on CPUs
+ * without PSE, gets page tables; they come from low memory that
+ * boot.c already mapped.
+ *
+ * With PAE the four pgd entries each point to a page of 512 pmds; the
+ * pmd level is folded into the pgd otherwise.
+ */
+static void __init pagetable_init(void)
+{
+	unsigned long vaddr, end;
+	pgd_t *pgd, *pgd_base = swapper_pg_dir;
+	pmd_t *pmd;
+	pte_t *pte_base;
+	int i, j, k;
+
+	/*
+	 * Enable PSE if available
+	 */
+	if (cpu_has_pse)
+		set_in_cr4(X86_CR4_PSE);
+
+	/*
+	 * Enable PGE if available
+	 */
+	if (cpu_has_pge) {
+		set_in_cr4(X86_CR4_PGE);
+		__PAGE_KERNEL |= PAGE_GLOBAL;
+	}
+
+	end = (unsigned long)__va(max_low_pfn*PAGE_SIZE);
+
+	i = __pgd_offset(PAGE_OFFSET);
+	pgd = pgd_base + i;
+	for (; i < PTRS_PER_PGD; pgd++, i++) {
+		vaddr = i*PGDIR_SIZE;
+		if (vaddr >= end)
+			break;
+#ifdef CONFIG_X86_PAE
+		pmd = (pmd_t *) alloc_bootmem_low_pages(PAGE_SIZE);
+		set_pgd(pgd, __pgd(__pa(pmd) | PAGE_PRESENT));
+#else
+		pmd = (pmd_t *)pgd;
+#endif
+		if (pmd != pmd_offset(pgd, 0))
+			BUG();
+		for (j = 0; j < PTRS_PER_PMD; pmd++, j++) {
+			vaddr = i*PGDIR_SIZE + j*PMD_SIZE;
+			if (vaddr >= end)
+				break;
+			if (cpu_has_pse && vaddr + PMD_SIZE <= end) {
+				set_pmd(pmd, __pmd(__pa(vaddr) | __PAGE_KERNEL | PAGE_PSE));
+				continue;
+			}
+			pte_base = (pte_t *) alloc_bootmem_low_pages(PAGE_SIZE);
+			for (k = 0; k < PTRS_PER_PTE; k++) {
+				vaddr = i*PGDIR_SIZE + j*PMD_SIZE + k*PAGE_SIZE;
+				if (vaddr >= end)
+					break;
+				set_pte(pte_base + k, mk_pte_phys(__pa(vaddr), PAGE_KERNEL));
+			}
+			set_pmd(pmd, __pmd(__pa(pte_base) | PAGE_PRESENT | PAGE_WRITE));
+		}
+	}
+
+	/*
+	 * Fixed mappings, only the page tables are allocated now
+	 */
+	vaddr = __fix_to_virt(__end_of_fixed_addresses - 1) & PMD_MASK;
+	fixrange_init(vaddr, 0, pgd_base);
+
+#ifdef CONFIG_HIGHMEM
+	/*
+	 * Permanent kmaps:
+	 */
+	vaddr = PKMAP_BASE;
+	fixrange_init(vaddr, vaddr + PAGE_SIZE*LAST_PKMAP, pgd_base);
+
+	pgd = swapper_pg_dir + __pgd_offset(vaddr);
+	pmd = pmd_offset(pgd, vaddr);
+	pkmap_page_table = pte_offset(pmd, vaddr);
+#endif
 
+	/*
+	 * The __init code and data are linked at their physical address
+	 * and run from the identity mapping until start_kernel() is done
+	 * with them, so alias low memory at 0 as boot.c did (the first
+	 * 4MB, or the first 1GB with PAE). It goes away in
+	 * zap_low_mappings().
+	 */
+	pgd_base[0] = pgd_base[__pgd_offset(PAGE_OFFSET)];
 
+#ifdef CONFIG_X86_PAE
+	enable_pae(swapper_pg_dir);
+#else
+	load_cr3(swapper_pg_dir);
+#endif
+	__flush_tlb_all();
+	printk("direct map: %luMB, %s pages%s%s\n", (end - PAGE_OFFSET) >> 20,
+		cpu_has_pse ? (PMD_SHIFT == 21 ? "2MB" : "4MB") : "4KB",
+		cpu_has_pge ? ", global" : "",
+		PTRS_PER_PMD > 1 ? ", PAE" : "");
+}
+
+/*
+ * Drop the identity mapping of low memory once nothing runs from
+ * .text.init any more. The alias may be global, so flush those too,
+ * on every CPU; the flush also reloads CR3, which PAE needs to see the
+ * new pgds. Not __init, for obvious reasons.
+ */
+void zap_low_mappings(void)
+{
+	int i;
+
+	for (i = 0; i < __pgd_offset(PAGE_OFFSET); i++)
+		set_pgd(swapper_pg_dir + i, __pgd(0));
+	flush_tlb_all();
+}
+
+/*
+ * Number of page frames in [start_pfn, end_pfn) that are not RAM
+ * according to the (sanitized, non-overlapping) e820 map.
+ */
+static unsigned long __init e820_hole_size(unsigned long start_pfn,
+	unsigned long end_pfn)
+{
+	unsigned long ram = 0;
+	int i;
+
+	for (i = 0; i < e820.nr_map; i++) {
+		unsigned long long start, end;
+
+		if (e820.map[i].type != E820_RAM)
+			continue;
+		start = (e820.map[i].addr + PAGE_SIZE-1) >> PAGE_SHIFT;
+		end = (e820.map[i].addr + e820.map[i].size) >> PAGE_SHIFT;
+		if (start < start_pfn)
+			start = start_pfn;
+		if (end > end_pfn)
+			end = end_pfn;
+		if (start < end)
+			ram += end - start;
+	}
+	return end_pfn - start_pfn - ram;
+}
+
+/*
+ * Tell the memory model which page frames are RAM, up to max_low_pfn
+ * or with CONFIG_HIGHMEM up to highend_pfn; with CONFIG_SPARSEMEM only
+ * their sections get a mem_map.
+ */
+static void __init register_memory_present(void)
+{
+#ifdef CONFIG_HIGHMEM
+	unsigned long limit = highend_pfn;
+#else
+	unsigned long limit = max_low_pfn;
+#endif
+	int i;
+
+	for (i = 0; i < e820.nr_map; i++) {
+		unsigned long long start, end;
+
+		if (e820.map[i].type != E820_RAM)
+			continue;
+		start = (e820.map[i].addr + PAGE_SIZE-1) >> PAGE_SHIFT;
+		end = (e820.map[i].addr + e820.map[i].size) >> PAGE_SHIFT;
+		if (end > limit)
+			end = limit;
+		if (start < end)
+			memory_present(0, start, end);
+	}
+}
+
+static void __init zone_sizes_init(void)
+{
+	unsigned long zones_size[MAX_NR_ZONES] = {0, 0, 0};
+	unsigned long zholes_size[MAX_NR_ZONES] = {0, 0, 0};
+	unsigned int max_dma, low;
+
+	max_dma = virt_to_phys((char *)MAX_DMA_ADDRESS) >> PAGE_SHIFT;
+	low = max_low_pfn;
+
+	if (low < max_dma)
+		zones_size[ZONE_DMA] = low;
+	else {
+		zones_size[ZONE_DMA] = max_dma;
+		zones_size[ZONE_NORMAL] = low - max_dma;
+	}
+	// 区域中不是内存的页帧（BIOS 区、ACPI 表等）不计入区域的实际大小
+	zholes_size[ZONE_DMA] = e820_hole_size(0, zones_size[ZONE_DMA]);
+	zholes_size[ZONE_NORMAL] = e820_hole_size(zones_size[ZONE_DMA],
+						  low);
+#ifdef CONFIG_HIGHMEM
+	zones_size[ZONE_HIGHMEM] = highend_pfn - low;
+	zholes_size[ZONE_HIGHMEM] = e820_hole_size(low, highend_pfn);
+#endif
+	free_area_init_node(0, &contig_page_data, NULL, zones_size, 0, zholes_size);
+}
+
+/*
+ * paging_init() sets up the page tables - note that the first 4MB are
+ * already mapped by boot.c, the rest of low memory is mapped here and
+ * the kernel switches to swapper_pg_dir.
+ */
 void __init paging_init(void)
 {
   printk("paging_init start\n");
 
-	// pagetable_init();
+	pagetable_init();
+	register_memory_present();
+	sparse_init();
+	zone_sizes_init();
+#ifdef CONFIG_HIGHMEM
+	kmap_init();
+#endif
   
   printk("paging_init end\n");
-}
\ No newline at end of file
+}
+
+#ifdef CONFIG_HIGHMEM
+/*
+ * The boot allocator never sees high memory: hand every RAM range of
+ * the highmem zone to the buddy allocator in one go.
+ */
+static void __init set_highmem_pages_init(void)
+{
+	int i;
+
+	for (i = 0; i < e820.nr_map; i++) {
+		unsigned long long start, end;
+
+		if (e820.map[i].type != E820_RAM)
+			continue;
+		start = (e820.map[i].addr + PAGE_SIZE-1) >> PAGE_SHIFT;
+		end = (e820.map[i].addr + e820.map[i].size) >> PAGE_SHIFT;
+		if (start < highstart_pfn)
+			start = highstart_pfn;
+		if (end > highend_pfn)
+			end = highend_pfn;
+		if (start < end)
+			totalhigh_pages += free_pages_bootmem(start, end);
+	}
+	totalram_pages += totalhigh_pages;
+}
+#endif
+
+void __init mem_init(void)
+{
+	int codesize, datasize, initsize;
+
+#ifdef CONFIG_HIGHMEM
+	max_mapnr = num_physpages = highend_pfn;
+#else
+	max_mapnr = num_physpages = max_low_pfn;
+#endif
+	high_memory = (void *) __va(max_low_pfn * PAGE_SIZE);
+
+	/* this will put all low memory onto the freelists */
+	totalram_pages += free_all_bootmem();
+#ifdef CONFIG_HIGHMEM
+	set_highmem_pages_init();
+#endif
+
+	codesize =  (unsigned long) &_etext - (unsigned long) &_text;
+	datasize =  (unsigned long) &_edata - (unsigned long) &_etext;
+	initsize =  (unsigned long) __pa(&_text) - HIGH_MEMORY;
+
+	printk("Memory: %luk/%luk available (%dk kernel code, %dk data, %dk init, %ldk highmem)\n",
+		(unsigned long) totalram_pages << (PAGE_SHIFT-10),
+		max_mapnr << (PAGE_SHIFT-10),
+		codesize >> 10,
+		datasize >> 10,
+		initsize >> 10,
+		(unsigned long) (totalhigh_pages << (PAGE_SHIFT-10)));
+}
@@ -0,0 +1,119 @@
+/*
+ * arch/i386/mm/ioremap.c
+ *
+ * Re-map IO memory to kernel address space so that we can access it.
+ * This is needed for high PCI addresses that aren't mapped in the
+ * 640k-1MB IO memory area on PC's
+ *
+ * (C) Copyright 1995 1996 Linus Torvalds
+ */
+
+#include <linux/vmalloc.h>
+#include <linux/slab.h>
+#include <linux/mm.h>
+#include <linux/kernel.h>
+#include <asm/io.h>
+#include <asm/pgtable.h>
+#include <asm/stdio.h>
+
+static int remap_area_pages(unsigned long address, unsigned long phys_addr,
+				 unsigned long size, unsigned long flags)
+{
+	unsigned long end = address + size;
+	pgprot_t prot = __pgprot(PAGE_PRESENT | PAGE_WRITE | flags);
+	pte_t *pte = NULL;
+
+	phys_addr -= address;
+	for (; address < end; address += PAGE_SIZE) {
+		if (!pte || !(address & ~PMD_MASK)) {
+			pte = pte_alloc_kernel(pmd_offset(pgd_offset_k(address), address),
+					       address);
+			if (!pte)
+				return -1;
+		}
+		if (!pte_none(*pte))
+			printk(KERN_ERR "remap_area_pte: page already exists\n");
+		set_pte(pte, mk_pte_phys(address + phys_addr, prot));
+		pte++;
+	}
+	return 0;
+}
+
+/*
+ * Generic mapping function (not visible outside):
+ */
+
+/*
+ * Remap an arbitrary physical address space into the kernel virtual
+ * address space. Needed when the kernel wants to access high addresses
+ * directly.
+ *
+ * NOTE! We need to allow non-page-aligned mappings too: we will obviously
+ * have to convert them into an offset in a page-aligned mapping, but the
+ * caller shouldn't need to know that small detail.
+ */
+void * __ioremap(unsigned long phys_addr, unsigned long size, unsigned long flags)
+{
+	void * addr;
+	struct vm_struct * area;
+	unsigned long offset, last_addr;
+
+	/* Don't allow wraparound or zero size */
+	last_addr = phys_addr + size - 1;
+	if (!size || last_addr < phys_addr)
+		return NULL;
+
+	/*
+	 * Don't remap the low PCI/ISA area, it's always mapped..
+	 */
+	if (phys_addr >= 0xA0000 && last_addr < 0x100000)
+		return phys_to_virt(phys_addr);
+
+	/*
+	 * Don't allow anybody to remap normal RAM that we're using..
+	 */
+	if (phys_addr < virt_to_phys(high_memory)) {
+		unsigned long pfn;
+
+		for (pfn = phys_addr >> PAGE_SHIFT;
+		     pfn <= (last_addr >> PAGE_SHIFT); pfn++) {
+			if (pfn_valid(pfn) && !PageReserved(pfn_to_page(pfn)))
+				return NULL;
+		}
+	}
+
+	/*
+	 * Mappings have to be page-aligned
+	 */
+	offset = phys_addr & ~PAGE_MASK;
+	phys_addr &= PAGE_MASK;
+	size = PAGE_ALIGN(last_addr + 1) - phys_addr;
+
+	/*
+	 * Ok, go for it..
+	 */
+	area = get_vm_area(size, VM_IOREMAP);
+	if (!area)
+		return NULL;
+	area->phys_addr = phys_addr;
+	addr = area->addr;
+	if (remap_area_pages((unsigned long) addr, phys_addr, size, flags)) {
+		iounmap(addr);
+		return NULL;
+	}
+	return (void *) (offset + (char *)addr);
+}
+
+void iounmap(void *addr)
+{
+	struct vm_struct *p;
+
+	if (addr <= high_memory)
+		return;
+	p = remove_vm_area((void *) (PAGE_MASK & (unsigned long) addr));
+	if (!p) {
+		printk(KERN_ERR "iounmap: bad address %p\n", addr);
+		return;
+	}
+	kfree(p);
+}
@@ -0,0 +1,20 @@
+#ifndef _BENCH_H
+#define _BENCH_H
+
+/*
+ * Helpers shared by the host micro-benchmarks, see bench/rt.c.
+ */
+
+extern int main(void);
+extern void bench_exit(int code);
+
+/* Low 32 bits of the TSC are plenty for a single run */
+static inline unsigned long bench_cycles(void)
+{
+	unsigned long lo, hi;
+
+	__asm__ __volatile__("rdtsc" : "=a" (lo), "=d" (hi));
+	return lo;
+}
+
+#endif /* _BENCH_H */
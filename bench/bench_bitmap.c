@@ -0,0 +1,226 @@
+/*
+ * bench/bench_bitmap.c
+ *
+ * Compares the word-wide lib/bitmap.c range operations with the
+ * per-bit loops bootmem used before (one LOCK-prefixed instruction
+ * per page) on a 1M-bit map. Every case also checks that both
+ * versions leave the same bitmap behind.
+ */
+
+#include <linux/bitmap.h>
+#include <linux/string.h>
+#include <asm/processor.h>
+#include <asm/stdio.h>
+#include "bench.h"
+
+#define NBITS		(1UL << 20)
+#define NWORDS		BITS_TO_LONGS(NBITS)
+#define RUNS		5
+
+static unsigned long map_a[NWORDS] __attribute__((aligned(64)));
+static unsigned long map_b[NWORDS] __attribute__((aligned(64)));
+
+static int failed;
+
+/* Small LCG so the runs are reproducible */
+static unsigned long seed;
+
+static unsigned long rnd(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+/* ---- the per-bit versions, as bootmem used to do it ---- */
+
+static void perbit_set(unsigned long *map, unsigned long start, unsigned long nr)
+{
+	unsigned long i;
+
+	for (i = start; i < start + nr; i++)
+		test_and_set_bit(i, map);
+}
+
+static void perbit_clear(unsigned long *map, unsigned long start, unsigned long nr)
+{
+	unsigned long i;
+
+	for (i = start; i < start + nr; i++)
+		test_and_clear_bit(i, map);
+}
+
+static unsigned long perbit_weight(unsigned long *map, unsigned long nbits)
+{
+	unsigned long i, w = 0;
+
+	for (i = 0; i < nbits; i++)
+		if (test_bit(i, map))
+			w++;
+	return w;
+}
+
+static unsigned long perbit_find_area(unsigned long *map, unsigned long size,
+				      unsigned long nr, unsigned long align_mask)
+{
+	unsigned long i, j;
+
+	for (i = 0; i + nr <= size; i += align_mask + 1) {
+		for (j = i; j < i + nr; j++)
+			if (test_bit(j, map))
+				goto fail_block;
+		return i;
+fail_block:
+		;
+	}
+	return size;
+}
+
+/* ---- the test cases ---- */
+
+/*
+ * What a bootmem map looks like after a while: long allocated runs
+ * with holes too small for the request in between, and the only
+ * large enough hole at the very end.
+ */
+static void fill_fragmented(unsigned long *map)
+{
+	unsigned long i, nr;
+
+	memset(map, 0, NWORDS * sizeof(long));
+	seed = 2;
+	for (i = 0; i < NBITS - 4096; i += nr + rnd() % 40 + 1) {
+		nr = rnd() % 2000 + 1;
+		bitmap_set(map, i, nr);
+	}
+	bitmap_set(map, NBITS - 4096, 4096 - 1024);
+}
+
+/* Worst case for the word-wide search: a free bit every 97 bits */
+static void fill_sparse(unsigned long *map)
+{
+	unsigned long i;
+
+	memset(map, 0xff, NWORDS * sizeof(long));
+	for (i = 0; i < NBITS - 4096; i += 97)
+		clear_bit(i, map);
+	bitmap_clear(map, NBITS - 1024, 512);
+}
+
+static void case_set(int bulk)
+{
+	if (bulk)
+		bitmap_set(map_b, 3, NBITS - 6);
+	else
+		perbit_set(map_a, 3, NBITS - 6);
+}
+
+static void case_clear(int bulk)
+{
+	if (bulk)
+		bitmap_clear(map_b, 3, NBITS - 6);
+	else
+		perbit_clear(map_a, 3, NBITS - 6);
+}
+
+/* Like the reserve/free calls at boot: many ranges of a few pages */
+static void case_short_ranges(int bulk)
+{
+	unsigned long i, start, nr;
+
+	seed = 1;
+	for (i = 0; i < 4096; i++) {
+		start = rnd() % (NBITS - 512);
+		nr = rnd() % 300 + 1;
+		if (bulk) {
+			if (i & 1)
+				bitmap_clear(map_b, start, nr);
+			else
+				bitmap_set(map_b, start, nr);
+		} else {
+			if (i & 1)
+				perbit_clear(map_a, start, nr);
+			else
+				perbit_set(map_a, start, nr);
+		}
+	}
+}
+
+static unsigned long result_a, result_b;
+
+static void case_weight(int bulk)
+{
+	if (bulk)
+		result_b = bitmap_weight(map_b, NBITS - 5);
+	else
+		result_a = perbit_weight(map_a, NBITS - 5);
+}
+
+static void case_find_area(int bulk)
+{
+	if (bulk)
+		result_b = bitmap_find_next_zero_area(map_b, NBITS, 0, 64, 7);
+	else
+		result_a = perbit_find_area(map_a, NBITS, 64, 7);
+}
+
+/*
+ * Run @fn on both maps starting from the same contents, keep the best
+ * of RUNS timings and compare the outcome.
+ */
+static void run(const char *name, void (*fn)(int), void (*fill)(unsigned long *),
+		int check_result)
+{
+	unsigned long best[2] = { ~0UL, ~0UL }, t;
+	int bulk, r;
+
+	for (r = 0; r < RUNS; r++) {
+		for (bulk = 0; bulk < 2; bulk++) {
+			unsigned long *map = bulk ? map_b : map_a;
+
+			if (fill)
+				fill(map);
+			else
+				memset(map, 0x5a, NWORDS * sizeof(long));
+			t = bench_cycles();
+			fn(bulk);
+			t = bench_cycles() - t;
+			if (t < best[bulk])
+				best[bulk] = t;
+		}
+		if (memcmp(map_a, map_b, NWORDS * sizeof(long)) ||
+		    (check_result && result_a != result_b)) {
+			printk("  %s: bitmaps differ!\n", name);
+			failed = 1;
+			return;
+		}
+	}
+	t = best[0] * 10 / (best[1] ? : 1);
+	printk("  %-14s per-bit %10lu  bitmap %10lu cycles  (x%lu.%lu)\n", name,
+	       best[0], best[1], t / 10, t % 10);
+}
+
+static void run_all(void)
+{
+	run("set 1M", case_set, NULL, 0);
+	run("clear 1M", case_clear, NULL, 0);
+	run("short ranges", case_short_ranges, NULL, 0);
+	run("weight", case_weight, NULL, 1);
+	run("find area", case_find_area, fill_fragmented, 1);
+	run("find sparse", case_find_area, fill_sparse, 1);
+}
+
+int main(void)
+{
+	int has_xmm2 = cpu_has_xmm2;
+
+	printk("bitmap: %lu bits\n", NBITS);
+	printk("word-wide (rep stosl):\n");
+	clear_bit(X86_FEATURE_XMM2, boot_cpu_data.x86_capability);
+	run_all();
+	if (has_xmm2) {
+		printk("SSE2:\n");
+		set_bit(X86_FEATURE_XMM2, boot_cpu_data.x86_capability);
+		run_all();
+	}
+	return failed;
+}
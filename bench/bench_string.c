@@ -0,0 +1,294 @@
+/*
+ * bench/bench_string.c
+ *
+ * Compares arch/i386/lib/string.c with the byte-at-a-time versions it
+ * replaced, over a sweep of sizes and source/destination alignments.
+ * Every case first checks that both versions produce the same bytes
+ * (and the same guard bytes around them) or the same result.
+ */
+
+#include <linux/bitops.h>
+#include <linux/debug.h>
+#include <linux/string.h>
+#include <asm/processor.h>
+#include <asm/stdio.h>
+#include "bench.h"
+
+#define MAX_SIZE	(256 * 1024)
+#define GUARD		64
+#define RUNS		5
+/* bytes touched per timing, so small sizes loop more often */
+#define WORK		(512 * 1024)
+
+static char buf_src[MAX_SIZE + 2 * GUARD] __attribute__((aligned(64)));
+static char buf_a[MAX_SIZE + 2 * GUARD] __attribute__((aligned(64)));
+static char buf_b[MAX_SIZE + 2 * GUARD] __attribute__((aligned(64)));
+
+static const unsigned long sizes[] = {
+	7, 16, 64, 100, 256, 511, 512, 1024, 4096, 16384, 65536, MAX_SIZE
+};
+#define NR_SIZES	(sizeof(sizes) / sizeof(sizes[0]))
+
+/* dst/src byte offsets from a 64-byte boundary */
+static const int aligns[][2] = { { 0, 0 }, { 1, 3 }, { 4, 0 } };
+#define NR_ALIGNS	(sizeof(aligns) / sizeof(aligns[0]))
+
+static int failed;
+
+/* ---- the byte-at-a-time versions string.c used to have ---- */
+
+static void byte_memset(void* dst_, uint8_t value, uint32_t size) {
+   if(dst_ == NULL) {
+       BUG();
+   }
+   uint8_t* dst = (uint8_t*)dst_;
+   while (size-- > 0)
+      *dst++ = value;
+}
+
+static void byte_memcpy(void* dst_, const void* src_, uint32_t size) {
+   if(dst_ == NULL || src_ == NULL) {
+       BUG();
+   }
+   uint8_t* dst = dst_;
+   const uint8_t* src = src_;
+   while (size-- > 0)
+      *dst++ = *src++;
+}
+
+static int byte_memcmp(const void* a_, const void* b_, uint32_t size) {
+   const char* a = a_;
+   const char* b = b_;
+   if(a == NULL || b == NULL) {
+       BUG();
+   }
+   while (size-- > 0) {
+      if(*a != *b) {
+	    return *a > *b ? 1 : -1;
+      }
+      a++;
+      b++;
+   }
+   return 0;
+}
+
+static uint32_t byte_strlen(const char* str) {
+   if(str == NULL) {
+       BUG();
+   }
+   const char* p = str;
+   while(*p++);
+   return (p - str - 1);
+}
+
+static char* byte_strchr(const char* str, const uint8_t ch) {
+   if(str == NULL) {
+       BUG();
+   }
+   while (*str != 0) {
+      if (*str == ch) {
+          return (char*)str;
+      }
+      str++;
+   }
+   return NULL;
+}
+
+static char* byte_strcpy(char* dst_, const char* src_) {
+   if(dst_ == NULL || src_ == NULL) {
+       BUG();
+   }
+   char* r = dst_;
+   while((*dst_++ = *src_++));
+   return r;
+}
+
+static char * byte_strstr(const char * s1,const char * s2)
+{
+    int l1, l2;
+
+    l2 = byte_strlen(s2);
+    if (!l2)
+        return (char *) s1;
+    l1 = byte_strlen(s1);
+    while (l1 >= l2) {
+        l1--;
+        if (!byte_memcmp(s1,s2,l2))
+            return (char *) s1;
+        s1++;
+    }
+    return NULL;
+}
+
+/* ---- the test cases ---- */
+
+/*
+ * One case is called as fn(new, dst, src, size) and returns a value
+ * that has to be the same for both versions (0 for the copies/fills,
+ * whose output is compared byte by byte instead).
+ */
+typedef long (*case_fn)(int new, char *dst, char *src, unsigned long size);
+
+static long case_memset(int new, char *dst, char *src, unsigned long size)
+{
+	if (new)
+		memset(dst, 0xa5, size);
+	else
+		byte_memset(dst, 0xa5, size);
+	return 0;
+}
+
+static long case_memcpy(int new, char *dst, char *src, unsigned long size)
+{
+	if (new)
+		memcpy(dst, src, size);
+	else
+		byte_memcpy(dst, src, size);
+	return 0;
+}
+
+/* dst holds a copy of src that differs in the last byte */
+static long case_memcmp(int new, char *dst, char *src, unsigned long size)
+{
+	if (new)
+		return memcmp(src, dst, size);
+	return byte_memcmp(src, dst, size);
+}
+
+static long case_strlen(int new, char *dst, char *src, unsigned long size)
+{
+	if (new)
+		return strlen(src);
+	return byte_strlen(src);
+}
+
+/* 'Z' only appears as the last character of src */
+static long case_strchr(int new, char *dst, char *src, unsigned long size)
+{
+	if (new)
+		return strchr(src, 'Z') - src;
+	return byte_strchr(src, 'Z') - src;
+}
+
+static long case_strcpy(int new, char *dst, char *src, unsigned long size)
+{
+	if (new)
+		strcpy(dst, src);
+	else
+		byte_strcpy(dst, src);
+	return 0;
+}
+
+/* the needle is the last 8 characters of src */
+static long case_strstr(int new, char *dst, char *src, unsigned long size)
+{
+	char *needle = src + size - 8;
+
+	if (new)
+		return strstr(src, needle) - src;
+	return byte_strstr(src, needle) - src;
+}
+
+/*
+ * src: size - 1 printable characters without 'Z', then 'Z', then the
+ * terminator. dst: a copy of src whose last byte differs for memcmp,
+ * guard bytes elsewhere.
+ */
+static void fill(char *dst, char *src, unsigned long size, int for_cmp)
+{
+	unsigned long i;
+
+	byte_memset(buf_src, 0, sizeof(buf_src));
+	for (i = 0; i < size; i++)
+		src[i] = 'a' + (i * 7 + i / 13) % 25;
+	src[size - 1] = 'Z';
+	if (for_cmp) {
+		byte_memcpy(dst, src, size);
+		dst[size - 1] = 'Y';
+	}
+}
+
+static void run(const char *name, case_fn fn, int for_cmp, int str)
+{
+	unsigned long s, a;
+
+	for (s = 0; s < NR_SIZES; s++) {
+		for (a = 0; a < NR_ALIGNS; a++) {
+			unsigned long size = sizes[s], best[2] = { ~0UL, ~0UL };
+			unsigned long loops = WORK / size + 1, t, i;
+			char *dst[2], *src;
+			long result[2];
+			int new, r;
+
+			if (str && size < 16)
+				continue;
+			dst[0] = buf_a + GUARD + aligns[a][0];
+			dst[1] = buf_b + GUARD + aligns[a][0];
+			src = buf_src + GUARD + aligns[a][1];
+			for (r = 0; r < RUNS; r++) {
+				for (new = 0; new < 2; new++) {
+					byte_memset(new ? buf_b : buf_a, 0x3c, sizeof(buf_a));
+					fill(dst[new], src, size, for_cmp);
+					t = bench_cycles();
+					for (i = 0; i < loops; i++)
+						result[new] = fn(new, dst[new], src, size);
+					t = (bench_cycles() - t) / loops;
+					if (t < best[new])
+						best[new] = t;
+				}
+				if (result[0] != result[1] ||
+				    byte_memcmp(buf_a, buf_b, sizeof(buf_a))) {
+					printk("  %s size %lu align %d/%d: results differ!\n",
+					       name, size, aligns[a][0], aligns[a][1]);
+					failed = 1;
+					return;
+				}
+			}
+			t = best[0] * 10 / (best[1] ? : 1);
+			printk("  %-7s %6lu  %d/%d  byte %8lu  new %7lu cycles  (x%lu.%lu)\n",
+			       name, size, aligns[a][0], aligns[a][1],
+			       best[0], best[1], t / 10, t % 10);
+		}
+	}
+}
+
+static void run_mem(void)
+{
+	run("memset", case_memset, 0, 0);
+	run("memcpy", case_memcpy, 0, 0);
+	run("memcmp", case_memcmp, 1, 0);
+}
+
+static void run_all(void)
+{
+	run_mem();
+	run("strlen", case_strlen, 0, 1);
+	run("strchr", case_strchr, 0, 1);
+	run("strcpy", case_strcpy, 0, 1);
+	run("strstr", case_strstr, 0, 1);
+}
+
+int main(void)
+{
+	int has_xmm2 = cpu_has_xmm2, has_erms = cpu_has_erms;
+
+	printk("string: dst/src alignment, best of %d\n", RUNS);
+	printk("rep movsl/stosl, word-at-a-time:\n");
+	clear_bit(X86_FEATURE_XMM2, boot_cpu_data.x86_capability);
+	string_init();
+	run_all();
+	if (has_xmm2) {
+		printk("SSE2%s:\n", has_erms ? " and ERMS, as picked at boot" : "");
+		set_bit(X86_FEATURE_XMM2, boot_cpu_data.x86_capability);
+		string_init();
+		run_mem();
+	}
+	/* the SSE2 memset/memcpy are only picked on CPUs without ERMS */
+	if (has_xmm2 && has_erms) {
+		printk("SSE2 without ERMS:\n");
+		clear_bit(X86_FEATURE_ERMS, boot_cpu_data.x86_capability);
+		string_init();
+		run_mem();
+	}
+	return failed;
+}
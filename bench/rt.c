@@ -0,0 +1,93 @@
+/*
+ * bench/rt.c
+ *
+ * Minimal runtime for running kernel code as a host process: the few
+ * symbols the kernel files expect (the console behind printk,
+ * panic_spin, boot_cpu_data) on top of raw Linux system calls, so no
+ * 32-bit libc is needed.
+ */
+
+#include <linux/console.h>
+#include <linux/init.h>
+#include <linux/string.h>
+#include <asm/processor.h>
+#include <asm/stdio.h>
+#include "bench.h"
+
+struct cpuinfo_x86 boot_cpu_data;
+
+static int sys_call3(int nr, int a, int b, int c)
+{
+	int ret;
+
+	__asm__ __volatile__("int $0x80"
+		: "=a" (ret)
+		: "0" (nr), "b" (a), "c" (b), "d" (c)
+		: "memory");
+	return ret;
+}
+
+static void stdout_console_write(struct console *co, const char *s,
+				 unsigned count)
+{
+	sys_call3(4, 1, (int)s, count);			// write(1, s, count)
+}
+
+static struct console stdout_console = {
+	.name	= "stdout",
+	.write	= stdout_console_write,
+	.flags	= CON_PRINTBUFFER,
+	.index	= -1,
+};
+
+/* called from console_init(), printk goes to stdout instead of the screen */
+void __init vga_console_init(void)
+{
+	register_console(&stdout_console);
+}
+
+/* there is no UART to program from user space */
+void __init serial_console_init(void)
+{
+}
+
+void bench_exit(int code)
+{
+	sys_call3(1, code, 0, 0);			// exit(code)
+	for (;;)
+		;
+}
+
+void panic_spin(char *filename, int line, const char *func)
+{
+	printk("PANIC %s:%d %s\n", filename, line, func);
+	bench_exit(1);
+}
+
+/*
+ * Only the capability words are needed here, user space can always
+ * run CPUID.
+ */
+static void bench_identify_cpu(struct cpuinfo_x86 *c)
+{
+	int eax, ebx, ecx, edx;
+
+	cpuid(0, &eax, &ebx, &ecx, &edx);
+	c->cpuid_level = eax;
+	if (c->cpuid_level >= 1) {
+		cpuid(1, &eax, &ebx, &ecx, &edx);
+		c->x86_capability[0] = edx;
+		c->x86_capability[1] = ecx;
+	}
+	if (c->cpuid_level >= 7) {
+		cpuid(7, &eax, &ebx, &ecx, &edx);
+		c->x86_capability[2] = ebx;
+	}
+}
+
+void _start(void)
+{
+	bench_identify_cpu(&boot_cpu_data);
+	console_init();
+	bench_exit(main());
+}
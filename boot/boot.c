@@ -24,9 +24,12 @@ extern void *flush;
 // __attribute__((__aligned__(PAGE_SIZE))) __attribute__ ((__section__
 // (".data.init")));   // 4 - 8M
 
-pgd_t pgd[1024] __attribute__((__aligned__(PAGE_SIZE)))
+// 启动阶段总是两级页表、32 位表项，与 CONFIG_X86_PAE 下的 pgd_t/pte_t 无关，
+// PAE 由 paging_init() 打开
+uint32_t pgd[1024] __attribute__((__aligned__(PAGE_SIZE)))
+__attribute__((__section__(".data.init")));
+uint32_t pte[1024] __attribute__((__aligned__(PAGE_SIZE)))
 __attribute__((__section__(".data.init")));
-pte_t pte[1024] __attribute__((__section__(".data.init")));
 
 unsigned long empty_zero_page[1024];
 
@@ -52,19 +55,19 @@ static struct gdt_desc __init make_gdt_desc(uint32_t *desc_addr, uint32_t limit,
 static void __init page_create(void) /* reate page*/
 {
   for (int i = 0; i < 1024; i++) {
-    pgd[i].pgd = 0;
+    pgd[i] = 0;
   }
 
-  pgd[0].pgd = (uint32_t)pte | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
-  pgd[768].pgd = (uint32_t)pte | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+  pgd[0] = (uint32_t)pte | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+  pgd[768] = (uint32_t)pte | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
   // pgd[1023] = (uint32_t)pgd | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
   uint32_t phy_addr = 0;
   for (int i = 0; i < 1024; i++) {
-    pte[i].pte_low = 0;
+    pte[i] = 0;
   }
   // create pte
   for (int i = 0; i < 1024; i++) {
-    pte[i].pte_low = phy_addr | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+    pte[i] = phy_addr | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
     phy_addr += PAGE_SIZE;
   }
 
@@ -0,0 +1,260 @@
+/*
+ *  linux/drivers/char/serial.c
+ *
+ *  Copyright (C) 1991, 1992  Linus Torvalds
+ *
+ *  The serial console on COM1, for headless runs (the qemu targets in
+ *  the makefile pass -serial stdio).
+ *
+ *  Output goes through a transmit ring. Whenever the UART reports an
+ *  empty transmit FIFO (THRE), up to a whole FIFO's worth of bytes is
+ *  pushed in one burst, from the THRE interrupt or, as long as there
+ *  is no interrupt to wait for, from the console write itself. Either
+ *  way the LSR is looked at once per burst instead of once per byte.
+ */
+
+#include <linux/console.h>
+#include <linux/errno.h>
+#include <linux/init.h>
+#include <linux/interrupt.h>
+#include <linux/serial_reg.h>
+#include <linux/spinlock.h>
+#include <asm/io.h>
+#include <asm/processor.h>
+#include <asm/stdio.h>
+#include <asm/system.h>
+
+#define SERIAL_PORT	0x3f8	/* COM1 */
+#define SERIAL_IRQ	4
+#define BASE_BAUD	115200	/* 1.8432MHz / 16 */
+#define SERIAL_BAUD	115200
+
+/* must be a power of 2 */
+#define SERIAL_XMIT_SIZE 4096
+
+#define CIRC_CNT(head,tail,size) (((head) - (tail)) & ((size)-1))
+#define CIRC_SPACE(head,tail,size) CIRC_CNT((tail),((head)+1),(size))
+
+static char xmit_buf[SERIAL_XMIT_SIZE];
+/*
+ * head is only moved by the console write, under the console lock,
+ * tail only by transmit_chars(). serial_lock covers the tail, the IER
+ * and the transmitter: the interrupt on the boot CPU and a writer on
+ * another CPU may both want to refill the FIFO.
+ */
+static volatile unsigned int xmit_head, xmit_tail;
+static spinlock_t serial_lock = SPIN_LOCK_UNLOCKED;
+
+static int xmit_fifo_size;	/* 16 on a 16550A, 1 on anything older */
+static unsigned char serial_ier;
+
+/*
+ * Set once rs_init() has the THRE interrupt. Until then nothing would
+ * ever drain the ring behind the writer's back, so the console write
+ * pushes everything out itself.
+ */
+static int serial_use_irq;
+
+static inline unsigned char serial_in(int offset)
+{
+	return inb(SERIAL_PORT + offset);
+}
+
+static inline void serial_out(int offset, unsigned char value)
+{
+	outb(value, SERIAL_PORT + offset);
+}
+
+/*
+ * Fill the transmit FIFO from the ring. Only call this with THRE set:
+ * the FIFO is empty then and takes xmit_fifo_size bytes without
+ * another look at the LSR. Called with serial_lock held.
+ */
+static void transmit_chars(void)
+{
+	int count = xmit_fifo_size;
+
+	while (count-- > 0 && xmit_head != xmit_tail) {
+		serial_out(UART_TX, xmit_buf[xmit_tail]);
+		xmit_tail = (xmit_tail + 1) & (SERIAL_XMIT_SIZE - 1);
+	}
+	// 环已经空了就关掉 THRE 中断，否则 FIFO 一空就又来一次
+	if (xmit_head == xmit_tail && (serial_ier & UART_IER_THRI)) {
+		serial_ier &= ~UART_IER_THRI;
+		serial_out(UART_IER, serial_ier);
+	}
+}
+
+/* Wait for the FIFO to drain and refill it from the ring, under serial_lock */
+static void transmit_wait(void)
+{
+	while (!(serial_in(UART_LSR) & UART_LSR_THRE))
+		cpu_relax();
+	transmit_chars();
+}
+
+/*
+ * Bytes typed on the console. There is no tty to hand them to, they
+ * are only debugging commands: with lock statistics 'l' prints them
+ * and 'c' clears them. Without, the receiver interrupt stays off.
+ */
+static void receive_chars(void)
+{
+	while (serial_in(UART_LSR) & UART_LSR_DR) {
+		switch (serial_in(UART_RX)) {
+#ifdef LOCK_STAT
+		case 'l':
+			lock_stat_show();
+			break;
+		case 'c':
+			lock_stat_clear();
+			break;
+#endif
+		}
+	}
+}
+
+/*
+ * The UART interrupt: refill the FIFO each time it runs empty, until
+ * the ring is empty too, and take in what was typed. What was typed
+ * may print, so receive_chars() runs without serial_lock.
+ */
+static irqreturn_t rs_interrupt(int irq, void *dev_id)
+{
+	unsigned char iir;
+	int handled = IRQ_NONE;
+
+	for (;;) {
+		spin_lock(&serial_lock);
+		iir = serial_in(UART_IIR);
+		if (iir & UART_IIR_NO_INT) {
+			spin_unlock(&serial_lock);
+			break;
+		}
+		if ((iir & UART_IIR_ID) == UART_IIR_THRI)
+			transmit_chars();
+		else if ((iir & UART_IIR_ID) != UART_IIR_RDI)
+			serial_in(UART_LSR);	/* clears the line status interrupt */
+		spin_unlock(&serial_lock);
+
+		if ((iir & UART_IIR_ID) == UART_IIR_RDI)
+			receive_chars();	/* data or FIFO timeout */
+		handled = IRQ_HANDLED;
+	}
+	return handled;
+}
+
+/*
+ * Queue the text, turning "\n" into "\r\n". Only blocks when the ring
+ * is full; with the interrupt in place the rest goes out in the
+ * background. Called with interrupts off (from an interrupt handler,
+ * early boot or a panic) there is nobody to take the interrupt, so
+ * the ring is drained right here then.
+ */
+static void serial_console_write(struct console *co, const char *s,
+				 unsigned count)
+{
+	unsigned int head = xmit_head;
+	unsigned long flags;
+
+	while (count) {
+		if (CIRC_SPACE(head, xmit_tail, SERIAL_XMIT_SIZE) < 2) {
+			// 环满了，等 FIFO 空出来再送一批
+			smp_wmb();
+			xmit_head = head;
+			spin_lock_irqsave(&serial_lock, flags);
+			transmit_wait();
+			spin_unlock_irqrestore(&serial_lock, flags);
+			continue;
+		}
+		if (*s == '\n') {
+			xmit_buf[head] = '\r';
+			head = (head + 1) & (SERIAL_XMIT_SIZE - 1);
+		}
+		xmit_buf[head] = *s++;
+		head = (head + 1) & (SERIAL_XMIT_SIZE - 1);
+		count--;
+	}
+	/* the bytes go in before transmit_chars() on another CPU sees them */
+	smp_wmb();
+	xmit_head = head;
+
+	spin_lock_irqsave(&serial_lock, flags);
+	if (serial_use_irq && (flags & X86_EFLAGS_IF)) {
+		/* the FIFO is probably empty already, THRI fires right away */
+		if (!(serial_ier & UART_IER_THRI)) {
+			serial_ier |= UART_IER_THRI;
+			serial_out(UART_IER, serial_ier);
+		}
+	} else {
+		while (xmit_head != xmit_tail)
+			transmit_wait();
+	}
+	spin_unlock_irqrestore(&serial_lock, flags);
+}
+
+static struct console serial_console = {
+	.name	= "ttyS",
+	.write	= serial_console_write,
+	.flags	= CON_PRINTBUFFER,
+	.index	= 0,
+};
+
+/*
+ * Program COM1 for 115200 8N1 with the FIFOs on, and register it as a
+ * console (which replays the log so far). Nothing is registered if
+ * there is no UART at the port.
+ */
+void __init serial_console_init(void)
+{
+	unsigned short quot = BASE_BAUD / SERIAL_BAUD;
+
+	// 先用 scratch 寄存器确认端口上有 UART
+	serial_out(UART_SCR, 0x5a);
+	if (serial_in(UART_SCR) != 0x5a)
+		return;
+
+	serial_ier = 0;
+	serial_out(UART_IER, 0);
+	serial_out(UART_LCR, UART_LCR_DLAB);
+	serial_out(UART_DLL, quot & 0xff);
+	serial_out(UART_DLM, quot >> 8);
+	serial_out(UART_LCR, UART_LCR_WLEN8);
+	serial_out(UART_FCR, UART_FCR_ENABLE_FIFO | UART_FCR_CLEAR_RCVR |
+		   UART_FCR_CLEAR_XMIT | UART_FCR_TRIGGER_14);
+	/* both IIR bits 7:6 set means a 16550A with working FIFOs */
+	xmit_fifo_size = (serial_in(UART_IIR) & 0xc0) == 0xc0 ? 16 : 1;
+	/* OUT2 connects the UART's interrupt line to the PIC */
+	serial_out(UART_MCR, UART_MCR_DTR | UART_MCR_RTS | UART_MCR_OUT2);
+	serial_in(UART_LSR);
+	serial_in(UART_RX);
+	serial_in(UART_IIR);
+
+	register_console(&serial_console);
+	printk("ttyS0 at I/O 0x%x (irq = %d) is a %s\n", SERIAL_PORT,
+	       SERIAL_IRQ, xmit_fifo_size > 1 ? "16550A" : "16450");
+}
+
+/*
+ * Hand the transmitter over to the THRE interrupt, now that there are
+ * interrupt handlers.
+ */
+static int __init rs_init(void)
+{
+	unsigned long flags;
+
+	if (!xmit_fifo_size)
+		return -ENODEV;		/* no UART, see serial_console_init() */
+	if (request_irq(SERIAL_IRQ, rs_interrupt, 0, "serial", &serial_console))
+		return -EBUSY;
+	spin_lock_irqsave(&serial_lock, flags);
+#ifdef LOCK_STAT
+	serial_ier |= UART_IER_RDI;
+	serial_out(UART_IER, serial_ier);
+#endif
+	serial_use_irq = 1;
+	spin_unlock_irqrestore(&serial_lock, flags);
+	return 0;
+}
+
+__initcall(rs_init);
@@ -0,0 +1,92 @@
+/*
+ * acpi.h - ACPI Interface
+ *
+ * Copyright (C) 2001 Paul Diefenbaugh <paul.s.diefenbaugh@intel.com>
+ *
+ * Only the tables the boot code reads to find the processors: the
+ * RSDP, the RSDT and the MADT ("APIC"). There is no AML interpreter.
+ */
+
+#ifndef _LINUX_ACPI_H
+#define _LINUX_ACPI_H
+
+#include <linux/init.h>
+#include <asm/types.h>
+
+#define ACPI_RSDP_SIG		"RSD PTR "
+#define ACPI_MADT_SIG		"APIC"
+
+/* Root System Description Pointer */
+struct acpi_table_rsdp {
+	char signature[8];
+	u8 checksum;
+	char oem_id[6];
+	u8 revision;
+	u32 rsdt_address;
+	/* revision 2 and up */
+	u32 length;
+	u64 xsdt_address;
+	u8 ext_checksum;
+	u8 reserved[3];
+} __attribute__ ((packed));
+
+struct acpi_table_header {
+	char signature[4];
+	u32 length;
+	u8 revision;
+	u8 checksum;
+	char oem_id[6];
+	char oem_table_id[8];
+	u32 oem_revision;
+	char asl_compiler_id[4];
+	u32 asl_compiler_revision;
+} __attribute__ ((packed));
+
+/* Root System Description Table: the header, then 32-bit table addresses */
+struct acpi_table_rsdt {
+	struct acpi_table_header header;
+	u32 entry[0];
+} __attribute__ ((packed));
+
+/* Multiple APIC Description Table */
+struct acpi_table_madt {
+	struct acpi_table_header header;
+	u32 lapic_address;
+	u32 flags;
+} __attribute__ ((packed));
+
+enum acpi_madt_entry_id {
+	ACPI_MADT_LAPIC = 0,
+	ACPI_MADT_IOAPIC,
+	ACPI_MADT_INT_SRC_OVR,
+	ACPI_MADT_NMI_SRC,
+	ACPI_MADT_LAPIC_NMI,
+	ACPI_MADT_LAPIC_ADDR_OVR,
+	ACPI_MADT_ENTRY_COUNT
+};
+
+struct acpi_table_entry_header {
+	u8 type;
+	u8 length;
+} __attribute__ ((packed));
+
+struct acpi_table_lapic {
+	struct acpi_table_entry_header header;
+	u8 acpi_id;
+	u8 id;
+	struct {
+		u32 enabled:1;
+		u32 reserved:31;
+	} flags;
+} __attribute__ ((packed));
+
+struct acpi_table_lapic_addr_ovr {
+	struct acpi_table_entry_header header;
+	u8 reserved[2];
+	u64 address;
+} __attribute__ ((packed));
+
+extern int acpi_find_rsdp(void);
+extern int acpi_boot_init(void);
+
+#endif /* _LINUX_ACPI_H */
@@ -0,0 +1,73 @@
+#ifndef __LINUX_BITMAP_H
+#define __LINUX_BITMAP_H
+
+#include <asm/types.h>
+#include <linux/bitops.h>
+
+/*
+ * bitmaps provide bit arrays that consume one or more unsigned
+ * longs. The bitmap interface and available operations are listed
+ * here, all of them work on whole words wherever they can:
+ *
+ * bitmap_set(dst, pos, nbits)			Set specified bit area
+ * bitmap_clear(dst, pos, nbits)		Clear specified bit area
+ * bitmap_weight(src, nbits)			Hamming Weight: number set bits
+ * bitmap_find_next_zero_area(buf, len, pos, n, mask)	Find bit free area
+ *
+ * Single bits and the find_{first,next}_{zero_,}bit() searches are
+ * in <asm/bitops.h>.
+ */
+
+#define BITS_PER_BYTE		8
+#define BITS_TO_LONGS(nr)	(((nr) + BITS_PER_LONG - 1) / BITS_PER_LONG)
+#define BIT_WORD(nr)		((nr) / BITS_PER_LONG)
+
+#define BITMAP_FIRST_WORD_MASK(start) (~0UL << ((start) % BITS_PER_LONG))
+#define BITMAP_LAST_WORD_MASK(nbits)					\
+(									\
+	((nbits) % BITS_PER_LONG) ?					\
+		(1UL<<((nbits) % BITS_PER_LONG))-1 : ~0UL		\
+)
+
+extern void bitmap_set(unsigned long *map, unsigned long start, unsigned long nr);
+extern void bitmap_clear(unsigned long *map, unsigned long start, unsigned long nr);
+extern unsigned long bitmap_weight(const unsigned long *bitmap, unsigned long nbits);
+extern unsigned long bitmap_find_next_zero_area_off(unsigned long *map,
+						    unsigned long size,
+						    unsigned long start,
+						    unsigned long nr,
+						    unsigned long align_mask,
+						    unsigned long align_offset);
+
+/**
+ * bitmap_find_next_zero_area - find a contiguous aligned zero area
+ * @map: The address to base the search on
+ * @size: The bitmap size in bits
+ * @start: The bitnumber to start searching at
+ * @nr: The number of zeroed bits we're looking for
+ * @align_mask: Alignment mask for zero area
+ *
+ * The @align_mask should be one less than a power of 2; the effect is that
+ * the bit offset of all zero areas this function finds is multiples of that
+ * power of 2. A @align_mask of 0 means no alignment is required.
+ */
+static inline unsigned long
+bitmap_find_next_zero_area(unsigned long *map, unsigned long size,
+			   unsigned long start, unsigned long nr,
+			   unsigned long align_mask)
+{
+	return bitmap_find_next_zero_area_off(map, size, start, nr,
+					      align_mask, 0);
+}
+
+static inline void bitmap_zero(unsigned long *dst, unsigned long nbits)
+{
+	bitmap_clear(dst, 0, nbits);
+}
+
+static inline void bitmap_fill(unsigned long *dst, unsigned long nbits)
+{
+	bitmap_set(dst, 0, nbits);
+}
+
+#endif /* __LINUX_BITMAP_H */
@@ -4,7 +4,10 @@
 #ifndef _LINUX_BOOTMEM_H
 #define _LINUX_BOOTMEM_H
 
+#include <asm/dma.h>
+#include <linux/cache.h>
 #include <linux/init.h>
+#include <linux/mmzone.h>
 
 /*
  *  simple boot-time physical memory area allocator.
@@ -45,7 +48,7 @@ extern unsigned long __init free_all_bootmem (void);
 // extern void __init reserve_bootmem_node (pg_data_t *pgdat, unsigned long physaddr, unsigned long size);
 // extern void __init free_bootmem_node (pg_data_t *pgdat, unsigned long addr, unsigned long size);
 // extern unsigned long __init free_all_bootmem_node (pg_data_t *pgdat);
-// extern void * __init __alloc_bootmem_node (pg_data_t *pgdat, unsigned long size, unsigned long align, unsigned long goal);
+extern void * __init __alloc_bootmem_node (pg_data_t *pgdat, unsigned long size, unsigned long align, unsigned long goal);
 #define alloc_bootmem_node(pgdat, x) \
 	__alloc_bootmem_node((pgdat), (x), SMP_CACHE_BYTES, __pa(MAX_DMA_ADDRESS))
 #define alloc_bootmem_pages_node(pgdat, x) \
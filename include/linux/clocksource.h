@@ -0,0 +1,79 @@
+/*  linux/include/linux/clocksource.h
+ *
+ *  This file contains the structure definitions for clocksources.
+ *
+ *  If you are not a clocksource, or timekeeping code, you should
+ *  not be including this file!
+ */
+#ifndef _LINUX_CLOCKSOURCE_H
+#define _LINUX_CLOCKSOURCE_H
+
+#include <asm/div64.h>
+
+typedef unsigned long long cycle_t;
+
+/**
+ * struct clocksource - hardware abstraction for a free running counter
+ *	Provides mostly state-free accessors to the underlying hardware.
+ *
+ * @name:		ptr to clocksource name
+ * @rating:		rating value for selection (higher is better)
+ * @read:		returns a cycle value
+ * @mult:		cycle to nanosecond multiplier
+ * @shift:		cycle to nanosecond divisor (power of two, <= 32)
+ */
+struct clocksource {
+	const char *name;
+	int rating;
+	cycle_t (*read)(void);
+	unsigned long mult;
+	int shift;
+};
+
+/**
+ * clocksource_khz2mult - calculates mult from khz and shift
+ * @khz:		Clocksource frequency in KHz
+ * @shift_constant:	Clocksource shift factor
+ *
+ * Helper functions that converts a khz counter frequency to a timsource
+ * multiplier, given the clocksource shift value
+ */
+static inline unsigned long clocksource_khz2mult(unsigned long khz,
+						 int shift_constant)
+{
+	/*  khz = cyc/(Million ns)
+	 *  mult/2^shift  = ns/cyc
+	 *  mult = ns/cyc * 2^shift
+	 *  mult = 1Million/khz * 2^shift
+	 *  mult = 1000000 * 2^shift / khz
+	 *  mult = (1000000<<shift) / khz
+	 */
+	unsigned long long tmp = ((unsigned long long)1000000) << shift_constant;
+
+	tmp += khz/2; /* round for do_div */
+	do_div(tmp, khz);
+
+	return (unsigned long)tmp;
+}
+
+/**
+ * clocksource_cyc2ns - converts clocksource cycles to nanoseconds
+ *
+ * (cyc * mult) >> shift would overflow after a few minutes at GHz
+ * rates, so the two halves of @cyc are scaled separately.
+ */
+static inline unsigned long long clocksource_cyc2ns(cycle_t cyc,
+						    unsigned long mult,
+						    int shift)
+{
+	unsigned long long hi = (unsigned long long)(unsigned long)(cyc >> 32) * mult;
+	unsigned long long lo = (unsigned long long)(unsigned long)cyc * mult;
+
+	return (hi << (32 - shift)) + (lo >> shift);
+}
+
+extern void clocksource_register(struct clocksource *cs);
+extern int clocksource_available(void);
+extern unsigned long long clocksource_read_ns(void);
+
+#endif
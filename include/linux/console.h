@@ -0,0 +1,37 @@
+#ifndef _LINUX_CONSOLE_H_
+#define _LINUX_CONSOLE_H_
+
+/*
+ * The interface for a console. printk() only appends to the log
+ * buffer, the records reach the consoles' ->write() from whoever holds
+ * the console lock, see kernel/printk.c.
+ */
+struct console
+{
+	char	name[8];
+	void	(*write)(struct console *, const char *, unsigned);
+	short	flags;
+	short	index;
+	struct	console *next;
+};
+
+#define CON_PRINTBUFFER	(1)	/* replay the log buffer when registered */
+#define CON_ENABLED	(4)
+
+extern struct console *console_drivers;
+extern int console_loglevel;
+
+extern void register_console(struct console *);
+extern int unregister_console(struct console *);
+extern void console_init(void);
+
+extern int console_trylock(void);
+extern void console_unlock(void);
+extern void console_flush(void);
+extern void console_flush_on_panic(void);
+
+/* the consoles themselves */
+extern void vga_console_init(void);
+extern void serial_console_init(void);
+
+#endif /* _LINUX_CONSOLE_H */
@@ -8,7 +8,7 @@
 #define __initdata	__attribute__ ((__section__ (".data.init")))	// 用于将数据标记为位于".data.init"节的数据
 #define __exitdata	__attribute__ ((unused, __section__ (".data.exit")))	// 用于将数据标记为位于".data.exit"节的数据
 #define __initsetup	__attribute__ ((unused,__section__ (".setup.init")))	// 用于将函数或变量标记为位于".setup.init"节的代码
-#define __init_call	__attribute__ ((unused,__section__ (".initcall.init")))	// 用于将函数或变量标记为位于".initcall.init"节的代码
+#define __init_call	__attribute__ ((used,__section__ (".initcall.init")))	// 用于将函数或变量标记为位于".initcall.init"节的代码
 #define __exit_call	__attribute__ ((unused,__section__ (".exitcall.exit")))	// 用于将函数或变量标记为位于".exitcall.exit"节的代码
 /*
  * Used for initialization calls..
@@ -23,7 +23,7 @@ extern initcall_t __initcall_start, __initcall_end;
 #define __exitcall(fn)								\
 	static exitcall_t __exitcall_##fn __exit_call = fn
 // 定义宏__init_call，用于将函数或变量标记为位于".initcall.init"节的代码
-#define __init_call	__attribute__ ((unused,__section__ (".initcall.init")))
+#define __init_call	__attribute__ ((used,__section__ (".initcall.init")))
 
 void init_all(void);
 #endif
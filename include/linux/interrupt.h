@@ -0,0 +1,40 @@
+/* interrupt.h */
+#ifndef _LINUX_INTERRUPT_H
+#define _LINUX_INTERRUPT_H
+
+#include <asm/irq.h>
+
+/*
+ * What a handler tells do_IRQ(): whether the interrupt was its
+ * device's. Handlers on a shared line are all called in turn.
+ */
+typedef int irqreturn_t;
+#define IRQ_NONE	(0)
+#define IRQ_HANDLED	(1)
+
+typedef irqreturn_t (*irq_handler_t)(int irq, void *dev_id);
+
+/*
+ * One handler on an IRQ line, chained through ->next when the line is
+ * shared (SA_SHIRQ on every one of them).
+ */
+struct irqaction {
+	irq_handler_t handler;
+	unsigned long flags;
+	const char *name;
+	void *dev_id;
+	struct irqaction *next;
+};
+
+#define SA_SHIRQ	0x04000000	/* the line may be shared */
+
+extern int request_irq(unsigned int irq, irq_handler_t handler,
+		       unsigned long irqflags, const char *devname,
+		       void *dev_id);
+extern void free_irq(unsigned int irq, void *dev_id);
+extern int setup_irq(unsigned int irq, struct irqaction *new);
+
+extern void trap_init(void);
+extern void init_IRQ(void);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef _LINUX_JIFFIES_H
+#define _LINUX_JIFFIES_H
+
+#include <linux/seqlock.h>
+#include <asm/param.h>
+#include <asm/timex.h>
+#include <asm/types.h>
+
+#define LATCH  ((CLOCK_TICK_RATE + HZ/2) / HZ)	/* For divider */
+
+#define NSEC_PER_SEC	1000000000L
+#define NSEC_PER_MSEC	1000000L
+#define TICK_NSEC	(NSEC_PER_SEC / HZ)
+
+/*
+ * The 32-bit jiffies value wraps in under 500 days at HZ=100, always
+ * compare two of them with the macros below.
+ */
+extern unsigned long volatile jiffies;
+
+/*
+ * All 64 bits don't wrap. They can't be read in one go on i386, so
+ * readers use get_jiffies_64(), consistent against the tick through
+ * xtime_lock.
+ */
+extern u64 jiffies_64;
+extern seqlock_t xtime_lock;
+extern u64 get_jiffies_64(void);
+
+/*
+ *	These inlines deal with timer wrapping correctly. You are 
+ *	strongly encouraged to use them
+ *	1. Because people otherwise forget
+ *	2. Because if the timer wrap changes in future you wont have to
+ *	   alter your driver code.
+ *
+ * time_after(a,b) returns true if the time a is after time b.
+ */
+#define time_after(a,b)		((long)(b) - (long)(a) < 0)
+#define time_before(a,b)	time_after(b,a)
+
+#define time_after_eq(a,b)	((long)(a) - (long)(b) >= 0)
+#define time_before_eq(a,b)	time_after_eq(b,a)
+
+#endif
@@ -3,6 +3,9 @@
 // 内核页表建立后的指针
 
 #define asmlinkage __attribute__((regparm(0)))
+/* 前三个参数经 eax、edx、ecx 传递，汇编里调用更省事 */
+#define fastcall __attribute__((regparm(3)))
+#define FASTCALL(x) x __attribute__((regparm(3)))
 #define SYMBOL_NAME_STR(X) #X
 #define SYMBOL_NAME(X) X
 #define __ALIGN .align 4, 0x90
@@ -0,0 +1,47 @@
+#ifndef __LINUX_LOCKSTAT_H
+#define __LINUX_LOCKSTAT_H
+
+/*
+ * Lock statistics, with DEBUG_SPINLOCKS 3 on SMP (see linux/spinlock.h).
+ *
+ * Locks are counted by class: all the locks initialized at the same
+ * place in the source, such as every zone's lock or every slab cache's,
+ * are one class, named after that place. A lock finds its class the
+ * first time it is taken.
+ */
+
+#include <linux/stringify.h>
+#include <asm/processor.h>
+#include <asm/timex.h>
+
+struct lock_class;
+
+struct lock_stat_map {
+	const char *site;		/* "file:line" the lock was initialized at */
+	struct lock_class *class;	/* looked up from site on first use */
+	cycles_t acquired;		/* when the holder got it */
+};
+
+#define LOCK_STAT_SITE		__FILE__ ":" __stringify(__LINE__)
+
+#define LOCK_STAT_MAP_INIT	{ LOCK_STAT_SITE, NULL, 0 }
+
+#define lock_stat_map_init(map)				\
+	do {							\
+		(map)->site = LOCK_STAT_SITE;			\
+		(map)->class = NULL;				\
+	} while (0)
+
+/* Wait and hold times are in TSC cycles, and 0 without a TSC */
+static inline cycles_t lock_stat_clock(void)
+{
+	return cpu_has_tsc ? get_cycles() : 0;
+}
+
+extern void lock_stat_acquired(struct lock_stat_map *map, int contended,
+			       cycles_t wait);
+extern void lock_stat_release(struct lock_stat_map *map);
+extern void lock_stat_show(void);
+extern void lock_stat_clear(void);
+
+#endif /* __LINUX_LOCKSTAT_H */
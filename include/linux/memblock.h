@@ -0,0 +1,71 @@
+#ifndef _LINUX_MEMBLOCK_H
+#define _LINUX_MEMBLOCK_H
+
+/*
+ * Logical memory blocks.
+ *
+ * The early boot allocator keeps two sorted arrays of physical ranges
+ * instead of one bit per page: 'memory' holds the RAM reported by the
+ * e820 map, 'reserved' holds everything that is in use (kernel image,
+ * BIOS pages, boot-time allocations). Free memory is memory minus
+ * reserved, so reserve, free and allocate all cost O(regions).
+ */
+
+#include <linux/init.h>
+#include <asm/types.h>
+
+#define INIT_MEMBLOCK_REGIONS	128	// 每种区间数组的最大条目数
+
+struct memblock_region {
+	phys_addr_t base;	// 区间起始物理地址
+	phys_addr_t size;	// 区间大小（字节）
+};
+
+struct memblock_type {
+	unsigned long cnt;	/* number of regions */
+	unsigned long max;	/* size of the allocated array */
+	struct memblock_region *regions;
+};
+
+struct memblock {
+	phys_addr_t current_limit;	// 分配的上限地址，只从直接映射的低端内存中分配
+	struct memblock_type memory;	// 可用的物理内存（E820_RAM）
+	struct memblock_type reserved;	// 已经被占用的物理内存
+};
+
+extern struct memblock memblock;
+
+extern int memblock_add(phys_addr_t base, phys_addr_t size);
+extern int memblock_remove(phys_addr_t base, phys_addr_t size);
+extern int memblock_reserve(phys_addr_t base, phys_addr_t size);
+extern int memblock_free(phys_addr_t base, phys_addr_t size);
+extern phys_addr_t memblock_find_in_range(phys_addr_t start, phys_addr_t end,
+					  phys_addr_t size, phys_addr_t align);
+extern phys_addr_t memblock_alloc_range(phys_addr_t size, phys_addr_t align,
+					phys_addr_t start, phys_addr_t end);
+extern phys_addr_t memblock_phys_mem_size(void);
+extern void memblock_set_current_limit(phys_addr_t limit);
+extern int memblock_is_reserved(phys_addr_t addr);
+extern void memblock_dump_all(void);
+
+extern void __next_free_mem_range(unsigned long long *idx,
+				  phys_addr_t *out_start, phys_addr_t *out_end);
+
+/**
+ * for_each_free_mem_range - iterate through free memblock areas
+ * @i: unsigned long long used as loop variable
+ * @p_start: phys_addr_t pointer to output start address, can be %NULL
+ * @p_end: phys_addr_t pointer to output end address, can be %NULL
+ *
+ * Walks over free (memory && !reserved) areas of memblock in ascending
+ * address order.
+ */
+// 遍历 memory 减去 reserved 之后剩下的空闲区间，按地址从低到高
+#define for_each_free_mem_range(i, p_start, p_end)			\
+	for (i = 0, __next_free_mem_range(&i, p_start, p_end);		\
+	     i != (unsigned long long)-1;				\
+	     __next_free_mem_range(&i, p_start, p_end))
+
+#define MEMBLOCK_ALLOC_ACCESSIBLE	0	// 以 current_limit 作为分配上限
+
+#endif /* _LINUX_MEMBLOCK_H */
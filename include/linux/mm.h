@@ -0,0 +1,280 @@
+#ifndef _LINUX_MM_H
+#define _LINUX_MM_H
+
+#include <linux/init.h>
+#include <linux/list.h>
+#include <linux/mmzone.h>
+#include <asm/types.h>
+#include <asm/page.h>
+#include <asm/atomic.h>
+#include <asm/bitops.h>
+
+extern unsigned long max_mapnr;		// mem_map 中 struct page 的个数
+extern unsigned long num_physpages;	// 物理页面总数
+extern void * high_memory;			// 直接映射区的结束虚拟地址
+extern unsigned long totalram_pages;	// 交给伙伴系统管理的页面数
+
+/*
+ * Each physical page in the system has a struct page associated with
+ * it to keep track of whatever it is we are using the page for at the
+ * moment. Note that we have no way to track which tasks are using
+ * a page.
+ *
+ * mem_map holds one of these for every page frame, so it is kept at
+ * 32 bytes: two descriptors share a 64-byte cache line and none of
+ * them straddles one. The zone and node a page belongs to are not
+ * stored as pointers but packed into the top bits of page->flags
+ * (see page_zone()), and the kernel virtual address of a lowmem page
+ * is computed from its position in mem_map.
+ *
+ * Pages on the buddy free lists have a count of zero and are linked
+ * into zone->free_area[order].free_list through page->list; only the
+ * first page of a free block is on the list, page->private holds the
+ * order of the block.
+ */
+typedef struct page {
+	unsigned long flags;		/* atomic flags, some possibly
+					   updated asynchronously; zone and
+					   node number in the top bits */
+	atomic_t count;			// 引用计数，空闲页为 0
+	struct list_head list;		// 空闲时挂在 free_area 的链表上
+	unsigned long index;		// 页面在映射中的偏移
+	unsigned long private;		// 空闲块的阶
+	struct list_head lru;		// 页面换出使用的 LRU 链表
+} mem_map_t;
+
+/*
+ * Various page->flags bits:
+ *
+ * PG_reserved is set for special pages, which can never be swapped
+ * out. Some of them might not even exist (eg empty_bad_page)...
+ * Every page starts out reserved and only the ones handed to the
+ * buddy allocator by free_all_bootmem() lose the bit.
+ */
+#define PG_locked		 0	/* Page is locked. Don't touch. */
+#define PG_error		 1
+#define PG_referenced		 2
+#define PG_uptodate		 3
+#define PG_dirty		 4
+#define PG_active		 6
+#define PG_slab			 8
+#define PG_highmem		11
+#define PG_reserved		14
+
+#define PageLocked(page)	test_bit(PG_locked, &(page)->flags)
+#define PageActive(page)	test_bit(PG_active, &(page)->flags)
+#define PageReserved(page)	test_bit(PG_reserved, &(page)->flags)
+#define SetPageReserved(page)	set_bit(PG_reserved, &(page)->flags)
+#define ClearPageReserved(page)	clear_bit(PG_reserved, &(page)->flags)
+#define PageSlab(page)		test_bit(PG_slab, &(page)->flags)
+#define PageSetSlab(page)	set_bit(PG_slab, &(page)->flags)
+#define PageClearSlab(page)	clear_bit(PG_slab, &(page)->flags)
+#ifdef CONFIG_HIGHMEM
+#define PageHighMem(page)	test_bit(PG_highmem, &(page)->flags)
+#else
+#define PageHighMem(page)	0 /* needed to optimize away at compile time */
+#endif
+
+#define get_page(p)		atomic_inc(&(p)->count)
+#define put_page_testzero(p)	atomic_dec_and_test(&(p)->count)
+#define page_count(p)		atomic_read(&(p)->count)
+#define set_page_count(p,v)	atomic_set(&(p)->count, v)
+
+extern mem_map_t * mem_map;
+
+/*
+ * The top bits of page->flags hold the section (CONFIG_SPARSEMEM
+ * only), node and zone a page belongs to, below them are the PG_*
+ * bits:
+ *
+ *	| SECTION | NODE | ZONE | ... | FLAGS |
+ *
+ * zone_table[] maps the combined node and zone number back to the
+ * zone_t; it is filled in by free_area_init_core().
+ */
+#ifdef CONFIG_SPARSEMEM
+#define SECTIONS_WIDTH		SECTIONS_SHIFT
+#else
+#define SECTIONS_WIDTH		0
+#endif
+#define ZONES_SHIFT		2	/* ceil(log2(MAX_NR_ZONES)) */
+#define ZONETABLE_SHIFT		(NODES_SHIFT + ZONES_SHIFT)
+
+#define SECTIONS_PGSHIFT	(BITS_PER_LONG - SECTIONS_WIDTH)
+#define NODES_PGSHIFT		(SECTIONS_PGSHIFT - NODES_SHIFT)
+#define ZONETABLE_PGSHIFT	(NODES_PGSHIFT - ZONES_SHIFT)
+
+#define SECTIONS_MASK		((1UL << SECTIONS_WIDTH) - 1)
+#define NODES_MASK		((1UL << NODES_SHIFT) - 1)
+#define ZONES_MASK		((1UL << ZONES_SHIFT) - 1)
+#define ZONETABLE_MASK		((1UL << ZONETABLE_SHIFT) - 1)
+
+#define NODEZONE(node, zone)	(((node) << ZONES_SHIFT) | (zone))
+
+extern zone_t *zone_table[1 << ZONETABLE_SHIFT];
+
+static inline zone_t *page_zone(struct page *page)
+{
+	return zone_table[(page->flags >> ZONETABLE_PGSHIFT) & ZONETABLE_MASK];
+}
+
+static inline int page_zonenum(struct page *page)
+{
+	return (page->flags >> ZONETABLE_PGSHIFT) & ZONES_MASK;
+}
+
+static inline int page_to_nid(struct page *page)
+{
+	return (page->flags >> ZONETABLE_PGSHIFT) >> ZONES_SHIFT & NODES_MASK;
+}
+
+static inline void set_page_zone(struct page *page, unsigned long nodezone)
+{
+	page->flags &= ~(ZONETABLE_MASK << ZONETABLE_PGSHIFT);
+	page->flags |= (nodezone & ZONETABLE_MASK) << ZONETABLE_PGSHIFT;
+}
+
+#ifdef CONFIG_SPARSEMEM
+static inline unsigned long page_to_section(struct page *page)
+{
+	return (page->flags >> SECTIONS_PGSHIFT) & SECTIONS_MASK;
+}
+
+static inline void set_page_section(struct page *page, unsigned long section)
+{
+	page->flags &= ~(SECTIONS_MASK << SECTIONS_PGSHIFT);
+	page->flags |= (section & SECTIONS_MASK) << SECTIONS_PGSHIFT;
+}
+
+/*
+ * Both directions are O(1): the section number comes from the pfn or
+ * from page->flags, and each section's map is stored pre-biased by
+ * the section's first pfn.
+ */
+static inline struct page *pfn_to_page(unsigned long pfn)
+{
+	return __section_mem_map_addr(__pfn_to_section(pfn)) + pfn;
+}
+
+static inline unsigned long page_to_pfn(struct page *page)
+{
+	return page - __section_mem_map_addr(__nr_to_section(page_to_section(page)));
+}
+#else
+#define set_page_section(page, section)	do { } while (0)
+#endif
+
+static inline void set_page_links(struct page *page, unsigned long zone,
+	unsigned long node, unsigned long pfn)
+{
+	set_page_zone(page, NODEZONE(node, zone));
+	set_page_section(page, pfn_to_section_nr(pfn));
+}
+
+// 只有直接映射区的页面才有固定的内核虚拟地址
+static inline void *lowmem_page_address(struct page *page)
+{
+	return __va(page_to_pfn(page) << PAGE_SHIFT);
+}
+
+#ifdef CONFIG_HIGHMEM
+/*
+ * A highmem page only has an address while it is kmap()ed; that
+ * address is looked up in a hash in mm/highmem.c rather than kept in
+ * struct page, NULL if the page is not mapped.
+ */
+extern void *page_address(struct page *page);
+extern void set_page_address(struct page *page, void *virtual);
+extern void page_address_init(void);
+#else
+#define page_address(page)	lowmem_page_address(page)
+#endif
+
+/*
+ * There is only one page-allocator function, and two main namespaces to
+ * it. The alloc_page*() variants return 'struct page *' and as such
+ * can allocate highmem pages, the *get*page*() variants return
+ * virtual kernel addresses to the allocated page(s).
+ */
+extern struct page * _alloc_pages(unsigned int gfp_mask, unsigned int order);
+extern struct page * __alloc_pages(unsigned int gfp_mask, unsigned int order, zonelist_t *zonelist);
+extern struct page * alloc_pages_node(int nid, unsigned int gfp_mask, unsigned int order);
+
+static inline struct page * alloc_pages(unsigned int gfp_mask, unsigned int order)
+{
+	/*
+	 * Gets optimized away by the compiler.
+	 */
+	if (order >= MAX_ORDER)
+		return NULL;
+	return _alloc_pages(gfp_mask, order);
+}
+
+#define alloc_page(gfp_mask) alloc_pages(gfp_mask, 0)
+
+extern unsigned long __get_free_pages(unsigned int gfp_mask, unsigned int order);
+extern unsigned long get_zeroed_page(unsigned int gfp_mask);
+
+#define __get_free_page(gfp_mask) \
+		__get_free_pages((gfp_mask),0)
+
+#define __get_dma_pages(gfp_mask, order) \
+		__get_free_pages((gfp_mask) | GFP_DMA,(order))
+
+/*
+ * There is only one 'core' page-freeing function.
+ */
+extern void __free_pages(struct page *page, unsigned int order);
+extern void free_pages(unsigned long addr, unsigned int order);
+extern void free_hot_page(struct page *page);
+extern void free_cold_page(struct page *page);
+extern void drain_local_pages(void);
+
+#define __free_page(page) __free_pages((page), 0)
+#define free_page(addr) free_pages((addr),0)
+
+extern unsigned int nr_free_pages(void);
+extern void show_free_areas(void);
+extern int idle_zero_page(void);
+
+/*
+ * GFP bitmasks..
+ */
+/* Zone modifiers in GFP_ZONEMASK (see linux/mmzone.h - low four bits) */
+#define __GFP_DMA	0x01
+#define __GFP_HIGHMEM	0x02
+
+/* Action modifiers - doesn't change the zoning */
+#define __GFP_WAIT	0x10	/* Can wait and reschedule? */
+#define __GFP_HIGH	0x20	/* Should access emergency pools? */
+#define __GFP_IO	0x40	/* Can start low memory physical IO? */
+#define __GFP_HIGHIO	0x80	/* Can start high mem physical IO? */
+#define __GFP_FS	0x100	/* Can call down to low-level FS? */
+#define __GFP_COLD	0x200	/* Cache-cold page required */
+#define __GFP_ZERO	0x400	/* Return zeroed page on success */
+
+#define GFP_NOHIGHIO	(__GFP_HIGH | __GFP_WAIT | __GFP_IO)
+#define GFP_NOIO	(__GFP_HIGH | __GFP_WAIT)
+#define GFP_NOFS	(__GFP_HIGH | __GFP_WAIT | __GFP_IO | __GFP_HIGHIO)
+#define GFP_ATOMIC	(__GFP_HIGH)
+#define GFP_USER	(             __GFP_WAIT | __GFP_IO | __GFP_HIGHIO | __GFP_FS)
+#define GFP_HIGHUSER	(             __GFP_WAIT | __GFP_IO | __GFP_HIGHIO | __GFP_FS | __GFP_HIGHMEM)
+#define GFP_KERNEL	(__GFP_HIGH | __GFP_WAIT | __GFP_IO | __GFP_HIGHIO | __GFP_FS)
+
+/* Flag - indicates that the buffer will be suitable for DMA.  Ignored on some
+   platforms, used as appropriate on others */
+
+#define GFP_DMA		__GFP_DMA
+
+extern void __init free_area_init(unsigned long * zones_size);
+extern void __init free_area_init_node(int nid, pg_data_t *pgdat, struct page *pmap,
+	unsigned long * zones_size, unsigned long zone_start_paddr, 
+	unsigned long *zholes_size);
+extern void __init free_area_init_core(int nid, pg_data_t *pgdat, struct page **gmap,
+	unsigned long * zones_size, unsigned long zone_start_paddr, 
+	unsigned long *zholes_size, struct page *pmap);
+extern unsigned long __init free_pages_bootmem(unsigned long start_pfn,
+	unsigned long end_pfn);
+extern void __init mem_init(void);
+
+#endif
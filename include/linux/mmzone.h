@@ -2,7 +2,12 @@
 #define _LINUX_MMZONE_H
 
 #include <linux/list.h>
+#include <linux/seqlock.h>
 #include <linux/spinlock.h>
+#include <linux/cache.h>
+#include <linux/threads.h>
+#include <asm/page.h>
+#include <asm/sparsemem.h>
 
 /*
  * Free memory management - zoned buddy allocator.
@@ -21,6 +26,24 @@ typedef struct free_area_struct {
 	unsigned long		*map;					// 空闲页映射表，用于跟踪空闲页的状态。
 } free_area_t;
 
+/*
+ * Order-0 pages are handed out from small per-CPU lists in front of
+ * the buddy lists, refilled from and drained to them @batch pages at
+ * a time under zone->lock. The pages on these lists are not counted
+ * in zone->free_pages.
+ */
+struct per_cpu_pages {
+	int count;		/* number of pages in the list */
+	int low;		/* low watermark, refill needed */
+	int high;		/* high watermark, emptying needed */
+	int batch;		/* chunk size for buddy add/remove */
+	struct list_head list;	/* the list of pages */
+};
+
+struct per_cpu_pageset {
+	struct per_cpu_pages pcp[2];	/* 0: hot.  1: cold */
+} ____cacheline_aligned_in_smp;
+
 struct pglist_data;		// 内存管理的全局数据结构。它用于描述系统内存的分布和管理情况。
 
 /*
@@ -35,16 +58,31 @@ typedef struct zone_struct {	//管理区
 	/*
 	 * Commonly accessed fields:
 	 */
-  spinlock_t		lock;		// 并行访问时保护该管理区的自选锁
+  qspinlock_t		lock;		// 并行访问时保护该管理区的自选锁（排队锁，争用最多）
 	unsigned long		free_pages;		// 该管理区中空闲页面的总数
 	unsigned long		pages_min, pages_low, pages_high;	// 都是管理区的极值
 	int			need_balance;	//该标志位通知页面换出kswapd，平衡该管理区。
 
+	/*
+	 * per-CPU hot/cold page lists, only touched by their own CPU
+	 * with interrupts off
+	 */
+	struct per_cpu_pageset	pageset[NR_CPUS];
+
 	/*
 	 * free areas of different sizes
 	 */
 	free_area_t		free_area[MAX_ORDER];		// 空闲区域位图，由伙伴分配器使用
 
+	/*
+	 * order-0 pages cleared by the idle loop. They still count in
+	 * free_pages; __GFP_ZERO takes them first, everybody else only
+	 * when the buddy lists are empty.
+	 */
+	struct list_head	zero_list;
+	unsigned long		nr_zero_pages;
+	unsigned long		zero_pages_high;	// 空闲时最多预先清零这么多页
+
 	/*
 	 * wait_table		-- the array holding the hash table
 	 * wait_table_size	-- the size of the hash table array
@@ -80,7 +118,7 @@ typedef struct zone_struct {	//管理区
 	struct pglist_data	*zone_pgdat;	// 指向父pg_data_t
 	struct page		*zone_mem_map;			// 涉及的管理区在全局mem_map中的第一页
 	unsigned long		zone_start_paddr;	// 同node_start_paddr		节点起始物理地址。
-	unsigned long		zone_start_mapnr;	// 同node_start_mapnr		指出节点在全局mem_map中的页面偏移。在free_area_init_core()中，通过计算mem_map与该节点的局部mem_map中称为lmem_map之间的页面数，从而得到页面偏移
+	unsigned long		zone_start_mapnr;	// 区域第一页的页帧号。平坦模型下同node_start_mapnr		指出节点在全局mem_map中的页面偏移。在free_area_init_core()中，通过计算mem_map与该节点的局部mem_map中称为lmem_map之间的页面数，从而得到页面偏移
 
 	/*
 	 * rarely used fields:
@@ -94,6 +132,17 @@ typedef struct zone_struct {	//管理区
 #define ZONE_HIGHMEM		2
 #define MAX_NR_ZONES		3
 
+/*
+ * The node number is kept in page->flags next to the zone number, so
+ * the number of nodes is limited by the bits set aside for it there.
+ */
+#ifndef CONFIG_NODES_SHIFT
+#define NODES_SHIFT		0	// UMA：只有一个节点
+#else
+#define NODES_SHIFT		CONFIG_NODES_SHIFT
+#endif
+#define MAX_NUMNODES		(1 << NODES_SHIFT)
+
 /*
  * One allocation request operates on a zonelist. A zonelist
  * is a list of zones, the first one is the 'goal' of the
@@ -109,6 +158,19 @@ typedef struct zonelist_struct {
 	zone_t * zones [MAX_NR_ZONES+1]; // NULL delimited
 } zonelist_t;
 
+/*
+ * build_zonelists() rewrites the zonelists inside a write section of
+ * zonelist_seq, its callers keep out each other. The allocator walks
+ * them without a lock and only looks at the count again before it
+ * fails, to retry if the lists changed under it.
+ *
+ * For now the zonelists are only built once, by free_area_init_core()
+ * before anything allocates, so the retry never happens. The count is
+ * there for rebuilding them at run time, when memory is added or a
+ * zone is emptied out; that must go through build_zonelists().
+ */
+extern seqcount_t zonelist_seq;
+
 #define GFP_ZONEMASK	0x0f
 
 /*
@@ -149,4 +211,114 @@ extern pg_data_t *pgdat_list;
 
 extern pg_data_t contig_page_data;
 
+#ifdef CONFIG_SPARSEMEM
+
+/*
+ * SECTION_SHIFT		#bits space required to store a section #
+ *
+ * PA_SECTION_SHIFT		physical address to/from section number
+ * PFN_SECTION_SHIFT		pfn to/from section number
+ */
+#define SECTIONS_SHIFT		(MAX_PHYSMEM_BITS - SECTION_SIZE_BITS)
+
+#define PA_SECTION_SHIFT	(SECTION_SIZE_BITS)
+#define PFN_SECTION_SHIFT	(SECTION_SIZE_BITS - PAGE_SHIFT)
+
+#define NR_MEM_SECTIONS		(1UL << SECTIONS_SHIFT)
+
+#define PAGES_PER_SECTION	(1UL << PFN_SECTION_SHIFT)
+#define PAGE_SECTION_MASK	(~(PAGES_PER_SECTION-1))
+
+struct page;
+
+/*
+ * Physical memory is split into sections of PAGES_PER_SECTION page
+ * frames, and only the sections that contain RAM get a piece of
+ * mem_map. MAX_ORDER blocks never cross a section, so the buddy
+ * allocator can still do pointer arithmetic within a block.
+ */
+struct mem_section {
+	/*
+	 * This is, logically, a pointer to an array of struct
+	 * pages.  However, it is stored with some other magic.
+	 * (see sparse.c::sparse_init_one_section())
+	 *
+	 * The first pfn of the section is subtracted from the address
+	 * of its map before it is stored, so that pfn_to_page() is a
+	 * single add. The low bits hold the SECTION_* flags below.
+	 */
+	unsigned long section_mem_map;
+};
+
+extern struct mem_section mem_section[NR_MEM_SECTIONS];
+
+/*
+ * We use the lower bits of the mem_map pointer to store
+ * a little bit of information.  There should be at least
+ * 3 bits here due to 32-bit alignment.
+ */
+#define	SECTION_MARKED_PRESENT	(1UL<<0)
+#define SECTION_HAS_MEM_MAP	(1UL<<1)
+#define SECTION_MAP_LAST_BIT	(1UL<<2)
+#define SECTION_MAP_MASK	(~(SECTION_MAP_LAST_BIT-1))
+
+static inline struct mem_section *__nr_to_section(unsigned long nr)
+{
+	return &mem_section[nr];
+}
+
+static inline struct page *__section_mem_map_addr(struct mem_section *section)
+{
+	unsigned long map = section->section_mem_map;
+	map &= SECTION_MAP_MASK;
+	return (struct page *)map;
+}
+
+static inline int valid_section(struct mem_section *section)
+{
+	return (section->section_mem_map & SECTION_MARKED_PRESENT);
+}
+
+static inline int section_has_mem_map(struct mem_section *section)
+{
+	return (section->section_mem_map & SECTION_HAS_MEM_MAP);
+}
+
+static inline unsigned long pfn_to_section_nr(unsigned long pfn)
+{
+	return pfn >> PFN_SECTION_SHIFT;
+}
+
+static inline unsigned long section_nr_to_pfn(unsigned long sec)
+{
+	return sec << PFN_SECTION_SHIFT;
+}
+
+static inline struct mem_section *__pfn_to_section(unsigned long pfn)
+{
+	return __nr_to_section(pfn_to_section_nr(pfn));
+}
+
+static inline int pfn_valid(unsigned long pfn)
+{
+	if (pfn_to_section_nr(pfn) >= NR_MEM_SECTIONS)
+		return 0;
+	return section_has_mem_map(__nr_to_section(pfn_to_section_nr(pfn)));
+}
+
+#define early_pfn_valid(pfn)	pfn_valid(pfn)
+
+extern void memory_present(int nid, unsigned long start, unsigned long end);
+extern void sparse_init(void);
+
+#else
+
+// 平坦模型下 mem_map 覆盖所有页帧
+#define early_pfn_valid(pfn)	(1)
+static inline void memory_present(int nid, unsigned long start,
+	unsigned long end) {}
+static inline void sparse_init(void) {}
+
+#endif /* CONFIG_SPARSEMEM */
+
 #endif
\ No newline at end of file
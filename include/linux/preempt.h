@@ -0,0 +1,17 @@
+#ifndef __LINUX_PREEMPT_H
+#define __LINUX_PREEMPT_H
+
+/*
+ * include/linux/preempt.h - macros for accessing and manipulating
+ * preempt_count (used for kernel preemption, interrupt count, etc.)
+ *
+ * There is no kernel preemption: kernel code runs until it gives the
+ * CPU up itself, so there is no count to keep and these cost nothing.
+ * They still say where code must not be preempted, should it ever be.
+ */
+
+#define preempt_disable()		do { } while (0)
+#define preempt_enable_no_resched()	do { } while (0)
+#define preempt_enable()		do { } while (0)
+
+#endif /* __LINUX_PREEMPT_H */
@@ -0,0 +1,112 @@
+/*
+ * linux/mm/slab.h
+ * Written by Mark Hemment, 1996.
+ * (markhe@nextd.demon.co.uk)
+ */
+
+#if	!defined(_LINUX_SLAB_H)
+#define	_LINUX_SLAB_H
+
+typedef struct kmem_cache_s kmem_cache_t;
+
+#include <linux/mm.h>
+#include <linux/cache.h>
+#include <asm/types.h>
+
+/* flags for kmem_cache_alloc() */
+#define	SLAB_NOFS		GFP_NOFS
+#define	SLAB_NOIO		GFP_NOIO
+#define SLAB_NOHIGHIO		GFP_NOHIGHIO
+#define	SLAB_ATOMIC		GFP_ATOMIC
+#define	SLAB_USER		GFP_USER
+#define	SLAB_KERNEL		GFP_KERNEL
+#define	SLAB_DMA		GFP_DMA
+
+#define SLAB_LEVEL_MASK		(__GFP_WAIT|__GFP_HIGH|__GFP_IO|__GFP_HIGHIO|__GFP_FS)
+#define	SLAB_NO_GROW		0x00001000UL	/* don't grow a cache */
+
+/* flags to pass to kmem_cache_create() */
+#define	SLAB_HWCACHE_ALIGN	0x00002000UL	/* align objs on a h/w cache lines */
+#define SLAB_CACHE_DMA		0x00004000UL	/* use GFP_DMA memory */
+
+/* flags passed to a constructor func */
+#define	SLAB_CTOR_CONSTRUCTOR	0x001UL		/* if not set, then deconstructor */
+#define SLAB_CTOR_ATOMIC	0x002UL		/* tell constructor it can't sleep */
+
+/* prototypes */
+extern void kmem_cache_init(void);
+extern void kmem_cache_sizes_init(void);
+
+extern kmem_cache_t *kmem_find_general_cachep(size_t, int gfpflags);
+extern kmem_cache_t *kmem_cache_create(const char *, size_t, size_t, unsigned long,
+				       void (*)(void *, kmem_cache_t *, unsigned long),
+				       void (*)(void *, kmem_cache_t *, unsigned long));
+extern int kmem_cache_destroy(kmem_cache_t *);
+extern int kmem_cache_shrink(kmem_cache_t *);
+extern void *kmem_cache_alloc(kmem_cache_t *, int);
+extern void kmem_cache_free(kmem_cache_t *, void *);
+extern unsigned int kmem_cache_size(kmem_cache_t *);
+
+extern int kmem_cache_reap(int);
+
+/*
+ * kmalloc() size classes: the powers of two from 32 bytes to 128KB,
+ * and between each pair a class at 3/4 of the larger one (48, 96,
+ * 192, ...). Objects from 192 bytes up start on a cache line, the
+ * 48 and 96 byte ones on 16 and 32 bytes.
+ */
+#define KMALLOC_SHIFT_LOW	5
+#define KMALLOC_SHIFT_HIGH	17
+#define KMALLOC_MIN_SIZE	(1UL << KMALLOC_SHIFT_LOW)
+#define KMALLOC_MAX_SIZE	(1UL << KMALLOC_SHIFT_HIGH)
+
+/* Size description struct for general caches. */
+struct cache_sizes {
+	size_t		 cs_size;
+	kmem_cache_t	*cs_cachep;
+	kmem_cache_t	*cs_dmacachep;
+};
+extern struct cache_sizes malloc_sizes[];
+
+/*
+ * Index of the smallest kmalloc() class that @size fits in, -1 if
+ * there is none. A macro rather than an inline function: this kernel
+ * is built with -O0, where nothing is inlined and a constant argument
+ * stops being one inside the callee, but a constant @size here is a
+ * constant expression.
+ */
+#define kmalloc_index(size) \
+	((size) <=     32 ?  0 : (size) <=     48 ?  1 : \
+	 (size) <=     64 ?  2 : (size) <=     96 ?  3 : \
+	 (size) <=    128 ?  4 : (size) <=    192 ?  5 : \
+	 (size) <=    256 ?  6 : (size) <=    384 ?  7 : \
+	 (size) <=    512 ?  8 : (size) <=    768 ?  9 : \
+	 (size) <=   1024 ? 10 : (size) <=   1536 ? 11 : \
+	 (size) <=   2048 ? 12 : (size) <=   3072 ? 13 : \
+	 (size) <=   4096 ? 14 : (size) <=   6144 ? 15 : \
+	 (size) <=   8192 ? 16 : (size) <=  12288 ? 17 : \
+	 (size) <=  16384 ? 18 : (size) <=  24576 ? 19 : \
+	 (size) <=  32768 ? 20 : (size) <=  49152 ? 21 : \
+	 (size) <=  65536 ? 22 : (size) <=  98304 ? 23 : \
+	 (size) <= 131072 ? 24 : -1)
+
+extern void *__kmalloc(size_t, int);
+extern void kfree(const void *);
+
+/*
+ * With a constant size (sizeof() of something, usually) the cache is
+ * picked at compile time and the call goes straight to
+ * kmem_cache_alloc(), otherwise __kmalloc() computes the class. The
+ * test has to be on the caller's expression, so this is a macro too;
+ * the branch not taken is folded away even at -O0.
+ */
+#define kmalloc(size, flags)						\
+	(__builtin_constant_p(size) ?					\
+	 (kmalloc_index(size) < 0 ? NULL :				\
+	  kmem_cache_alloc(((flags) & GFP_DMA) ?			\
+			   malloc_sizes[kmalloc_index(size)].cs_dmacachep :	\
+			   malloc_sizes[kmalloc_index(size)].cs_cachep,	\
+			   (flags))) :						\
+	 __kmalloc((size), (flags)))
+
+#endif	/* _LINUX_SLAB_H */
@@ -1,6 +1,9 @@
 #ifndef __LINUX_SPINLOCK_H
 #define __LINUX_SPINLOCK_H
 
+#include <linux/stringify.h>
+#include <asm/system.h>
+
 /*
  * These are the generic versions of the spinlocks and read-write
  * locks..
@@ -49,14 +52,28 @@
 #define LOCK_SECTION_END			\
 	".previous\n\t"
 
+/*
+ * 0 == no debugging, 1 == maintain lock state, 2 == full debug,
+ * 3 == lock statistics.
+ *
+ * 1 and 2 are for UP, where a spinlock is otherwise nothing at all.
+ * 3 is for SMP: acquisitions, contended acquisitions and the cycles
+ * spent waiting for and holding the locks are counted per lock class
+ * (see linux/lockstat.h), for lock_stat_show() to print. With one CPU
+ * nothing is ever contended, so there 3 is full debugging.
+ */
+#define DEBUG_SPINLOCKS	0
+
+#if (DEBUG_SPINLOCKS >= 3) && defined(CONFIG_SMP)
+#define LOCK_STAT
+#endif
+
 #ifdef CONFIG_SMP
 #include <asm/spinlock.h>
 
 #elif !defined(spin_lock_init) /* !SMP and spin_lock_init not previously
                                   defined (e.g. by including asm/spinlock.h */
 
-#define DEBUG_SPINLOCKS	0	/* 0 == no debugging, 1 == maintain lock state, 2 == full debug */
-
 #if (DEBUG_SPINLOCKS < 1)
 
 #define atomic_dec_and_lock(atomic,lock) atomic_dec_and_test(atomic)
@@ -85,6 +102,8 @@
 
 #elif (DEBUG_SPINLOCKS < 2)
 
+#include <asm/bitops.h>
+
 typedef struct {
 	volatile unsigned long lock;
 } spinlock_t;
@@ -108,6 +127,8 @@ typedef struct {
 #define SPIN_LOCK_UNLOCKED (spinlock_t) { 0, 25, __BASE_FILE__ }
 
 #include <linux/kernel.h>
+#include <asm/bitops.h>
+#include <asm/stdio.h>
 
 #define spin_lock_init(x)	do { (x)->lock = 0; } while (0)
 #define spin_is_locked(lock)	(test_bit(0,(lock)))
@@ -119,6 +140,13 @@ typedef struct {
 
 #endif	/* DEBUG_SPINLOCKS */
 
+/*
+ * With one CPU there is nobody to queue behind: the queued lock of
+ * SMP (see asm/spinlock.h) is just another spinlock.
+ */
+typedef spinlock_t qspinlock_t;
+#define QSPIN_LOCK_UNLOCKED SPIN_LOCK_UNLOCKED
+
 /*
  * Read-write spinlocks, allowing multiple readers
  * but only one writer.
@@ -142,8 +170,10 @@ typedef struct {
 
 #define rwlock_init(lock)	do { } while(0)
 #define read_lock(lock)		(void)(lock) /* Not "unused variable". */
+#define read_trylock(lock)	({1; })
 #define read_unlock(lock)	do { } while(0)
 #define write_lock(lock)	(void)(lock) /* Not "unused variable". */
+#define write_trylock(lock)	({1; })
 #define write_unlock(lock)	do { } while(0)
 
 #endif /* !SMP */
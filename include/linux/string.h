@@ -46,4 +46,7 @@ extern uint32_t strnlen(const char* str, uint32_t max);
 extern char * strstr(const char * s1,const char * s2);
 
 extern int strncmp(const char * cs,const char * ct,size_t count);
+
+/* 大块的 memset/memcpy/memcmp 是否用 SSE2，须在 cpu_init() 之后调用 */
+extern void string_init(void);
 #endif
@@ -0,0 +1,57 @@
+#ifndef __LINUX_VMALLOC_H
+#define __LINUX_VMALLOC_H
+
+#include <linux/mm.h>
+#include <linux/spinlock.h>
+#include <asm/pgtable.h>
+
+/* bits in vm_struct->flags */
+#define VM_IOREMAP	0x00000001	/* ioremap() and friends */
+#define VM_ALLOC	0x00000002	/* vmalloc() */
+
+/*
+ * A mapped range of the vmalloc window. size includes the unmapped
+ * guard page at the end.
+ */
+struct vm_struct {
+	unsigned long flags;
+	void * addr;
+	unsigned long size;
+	struct page **pages;		// vmalloc() 分配的页面
+	unsigned int nr_pages;
+	unsigned long phys_addr;	// ioremap() 映射的物理地址
+};
+
+extern struct vm_struct * get_vm_area (unsigned long size, unsigned long flags);
+extern struct vm_struct * remove_vm_area (void * addr);
+extern void vfree(void * addr);
+extern void * __vmalloc (unsigned long size, int gfp_mask, pgprot_t prot);
+extern int map_vm_area(struct vm_struct *area, pgprot_t prot, struct page **pages);
+extern void unmap_kernel_range(unsigned long addr, unsigned long size);
+extern void vmalloc_init(void);
+
+/*
+ *	Allocate any pages
+ */
+static inline void * vmalloc (unsigned long size)
+{
+	return __vmalloc(size, GFP_KERNEL | __GFP_HIGHMEM, PAGE_KERNEL);
+}
+
+/*
+ *	Allocate ISA addressable pages for broke crap
+ */
+static inline void * vmalloc_dma (unsigned long size)
+{
+	return __vmalloc(size, GFP_KERNEL|GFP_DMA, PAGE_KERNEL);
+}
+
+/*
+ *	vmalloc 32bit PA addressable pages - eg for PCI 32bit devices
+ */
+static inline void * vmalloc_32(unsigned long size)
+{
+	return __vmalloc(size, GFP_KERNEL, PAGE_KERNEL);
+}
+
+#endif
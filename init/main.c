@@ -1,16 +1,50 @@
 // init/main.c
 #include <asm/stdio.h>
 #include <asm/types.h>
+#include <linux/console.h>
 #include <linux/init.h>
+#include <linux/interrupt.h>
+#include <linux/mm.h>
+#include <linux/rcupdate.h>
+#include <linux/slab.h>
+#include <linux/smp.h>
+#include <linux/vmalloc.h>
+#include <asm/pgtable.h>
+#include <asm/timer.h>
 
 extern void __init setup_arch();
+extern void cpu_idle(void);
 extern uint8_t _start[];
 extern uint8_t _end[];
 
+// 依次调用 __initcall() 登记的初始化函数
+static void __init do_initcalls(void) {
+  initcall_t *call;
+
+  for (call = &__initcall_start; call < &__initcall_end; call++) (*call)();
+}
+
 void start_kernel(void) {
+  smp_prepare_boot_cpu();  // 每个 CPU 自己的 GDT，%fs 指向 PDA，smp_processor_id() 从这里取
+  console_init();   // printk 之前的记录在注册控制台时补打
   printk("Hello, OUROS.\n");
   printk("printk complete\n");
   printk("kernel in memory start: 0x%08X\n", _start);
   printk("kernel in memory end:   0x%08X\n", _end);
   setup_arch();
+  trap_init();  // 异常
+  init_IRQ();   // 8259 和外部中断
+  rcu_init();   // 每个 CPU 的回调链表，要在中断打开和唤醒其他 CPU 之前
+  kmem_cache_init();
+  mem_init();   // 把 bootmem 中空闲的内存交给伙伴系统
+  kmem_cache_sizes_init();  // 建立 kmalloc 的通用缓存
+  vmalloc_init();
+  time_init();  // PIT、TSC 和本地 APIC 定时器，要在 vmalloc_init 之后（ioremap）
+  smp_boot_cpus();  // 唤醒其他 CPU，要用 APIC 和 udelay，并且要在 zap_low_mappings 之前
+  do_initcalls();   // 驱动在这里申请中断
+
+  // 以下不能再调用 __init 函数：它们链接在低端的物理地址上
+  zap_low_mappings();
+  local_irq_enable();
+  cpu_idle();   // 空闲时预先清零页面，然后停机
 }
\ No newline at end of file
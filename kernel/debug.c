@@ -1,6 +1,7 @@
 #include <asm/print.h>
 // #include <asm-i386/interrupt.h>
 #include <asm/stdio.h>
+#include <linux/console.h>
 #include <linux/debug.h>
 
 /* 打印文件名,行号,函数名,条件并使程序悬停 */
@@ -16,6 +17,9 @@ void panic_spin(char* filename, int line, const char* func) {
   printk("function:");
   printk("%s", (char*)func);
   printk("\n");
+  // 就算控制台锁还被别人拿着也要把剩下的日志打出来；
+  // log_buf 留在内存里，可以用调试器的 dmesg 命令查看
+  console_flush_on_panic();
   while (1)
     ;
 }
@@ -0,0 +1,197 @@
+/*
+ *  linux/kernel/lockstat.c
+ *
+ *  Lock statistics, per lock class (see linux/lockstat.h).
+ *
+ *  Every CPU counts in its own row of lock_stats[], with interrupts off
+ *  so that a lock taken from an interrupt handler can't tear an update
+ *  in progress. The only thing the CPUs share is the class table,
+ *  which is written once per class, the first time one of its locks is
+ *  taken. lock_stat_show() adds the rows up.
+ */
+
+#include <linux/cache.h>
+#include <linux/kernel.h>
+#include <linux/smp.h>
+#include <linux/spinlock.h>
+#include <linux/string.h>
+#include <asm/stdio.h>
+#include <asm/system.h>
+
+#ifdef LOCK_STAT
+
+#define MAX_LOCK_CLASSES	64
+
+struct lock_class {
+	const char *site;
+};
+
+struct lock_class_stats {
+	unsigned long acquisitions;
+	unsigned long contended;
+	cycles_t wait_total, wait_max;
+	cycles_t hold_total, hold_max;
+};
+
+/* the last class takes whatever doesn't fit */
+static struct lock_class lock_classes[MAX_LOCK_CLASSES] = {
+	[MAX_LOCK_CLASSES - 1] = { "(other)" },
+};
+static int nr_lock_classes;
+
+static struct lock_class_stats lock_stats[NR_CPUS][MAX_LOCK_CLASSES]
+	__attribute__((__aligned__(SMP_CACHE_BYTES)));
+
+/* taken with the raw ticket lock calls, they don't count themselves */
+static spinlock_t lock_class_lock = SPIN_LOCK_UNLOCKED;
+static spinlock_t lock_stat_show_lock = SPIN_LOCK_UNLOCKED;
+
+/*
+ * Find the class of the locks initialized at @site, adding it if it
+ * is new. Sites are told apart by name: a lock initialized in a
+ * header has one site string per object file including it.
+ */
+static struct lock_class *lock_class_lookup(const char *site)
+{
+	int i;
+
+	/* a lock that was only ever zero-filled */
+	if (!site)
+		site = "(uninitialized)";
+
+	__ticket_spin_lock(&lock_class_lock);
+	for (i = 0; i < nr_lock_classes; i++)
+		if (!strcmp(lock_classes[i].site, site))
+			goto out;
+	if (nr_lock_classes < MAX_LOCK_CLASSES - 1)
+		lock_classes[nr_lock_classes++].site = site;
+	else
+		i = MAX_LOCK_CLASSES - 1;
+out:
+	__ticket_spin_unlock(&lock_class_lock);
+	return &lock_classes[i];
+}
+
+static inline struct lock_class_stats *this_cpu_stats(struct lock_class *class)
+{
+	return &lock_stats[smp_processor_id()][class - lock_classes];
+}
+
+/*
+ * Called right after the lock was taken. @wait is how long it took,
+ * if it wasn't free at the first try.
+ */
+void lock_stat_acquired(struct lock_stat_map *map, int contended,
+			cycles_t wait)
+{
+	struct lock_class_stats *stats;
+	unsigned long flags;
+
+	local_irq_save(flags);
+	if (!map->class)
+		map->class = lock_class_lookup(map->site);
+	stats = this_cpu_stats(map->class);
+	stats->acquisitions++;
+	if (contended) {
+		stats->contended++;
+		stats->wait_total += wait;
+		if (wait > stats->wait_max)
+			stats->wait_max = wait;
+	}
+	local_irq_restore(flags);
+	map->acquired = lock_stat_clock();
+}
+
+/*
+ * Called right before the lock is dropped, by the CPU that took it.
+ */
+void lock_stat_release(struct lock_stat_map *map)
+{
+	struct lock_class_stats *stats;
+	unsigned long flags;
+	cycles_t hold;
+
+	if (!map->class)
+		return;
+	hold = lock_stat_clock() - map->acquired;
+
+	local_irq_save(flags);
+	stats = this_cpu_stats(map->class);
+	stats->hold_total += hold;
+	if (hold > stats->hold_max)
+		stats->hold_max = hold;
+	local_irq_restore(flags);
+}
+
+/**
+ * lock_stat_show - print the lock statistics
+ *
+ * One line per class that was taken, the one waited for the longest
+ * first. Times are in TSC cycles. Nothing is printed if somebody else
+ * is printing them already.
+ */
+void lock_stat_show(void)
+{
+	static struct lock_class_stats sum[MAX_LOCK_CLASSES];
+	static int order[MAX_LOCK_CLASSES];
+	int cpu, i, j, n = 0;
+
+	if (!__ticket_spin_trylock(&lock_stat_show_lock))
+		return;
+
+	memset(sum, 0, sizeof(sum));
+	for (i = 0; i < MAX_LOCK_CLASSES; i++) {
+		for (cpu = 0; cpu < NR_CPUS; cpu++) {
+			struct lock_class_stats *s = &lock_stats[cpu][i];
+
+			sum[i].acquisitions += s->acquisitions;
+			sum[i].contended += s->contended;
+			sum[i].wait_total += s->wait_total;
+			sum[i].hold_total += s->hold_total;
+			if (s->wait_max > sum[i].wait_max)
+				sum[i].wait_max = s->wait_max;
+			if (s->hold_max > sum[i].hold_max)
+				sum[i].hold_max = s->hold_max;
+		}
+		if (!sum[i].acquisitions)
+			continue;
+		// 按等待总周期从大到小插入
+		for (j = n; j > 0; j--) {
+			if (sum[order[j - 1]].wait_total >= sum[i].wait_total)
+				break;
+			order[j] = order[j - 1];
+		}
+		order[j] = i;
+		n++;
+	}
+
+	printk("%-28s %10s %10s %14s %10s %14s %10s\n", "class", "acquired",
+	       "contended", "wait-total", "wait-max", "hold-total", "hold-max");
+	for (j = 0; j < n; j++) {
+		struct lock_class_stats *s = &sum[order[j]];
+
+		printk("%-28s %10lu %10lu %14Lu %10Lu %14Lu %10Lu\n",
+		       lock_classes[order[j]].site, s->acquisitions,
+		       s->contended, s->wait_total, s->wait_max,
+		       s->hold_total, s->hold_max);
+	}
+
+	__ticket_spin_unlock(&lock_stat_show_lock);
+}
+
+/**
+ * lock_stat_clear - start counting again
+ *
+ * The other CPUs aren't stopped: a count they are updating right now
+ * may survive the clear.
+ */
+void lock_stat_clear(void)
+{
+	unsigned long flags;
+
+	local_irq_save(flags);
+	memset(lock_stats, 0, sizeof(lock_stats));
+	local_irq_restore(flags);
+}
+
+#endif /* LOCK_STAT */
@@ -0,0 +1,352 @@
+/*
+ *  linux/kernel/printk.c
+ *
+ *  The kernel log buffer and the console output behind printk().
+ *
+ *  printk() never waits for a console: it appends one record to a
+ *  lockless ring and only writes to the consoles if nobody else is
+ *  doing so already. Whoever holds the console lock prints everything
+ *  that came in meanwhile before letting go of it.
+ */
+
+#include <linux/console.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include <asm/atomic.h>
+#include <asm/msr.h>
+#include <asm/processor.h>
+#include <asm/stdio.h>
+#include <asm/system.h>
+
+#define LOG_LINE_MAX	240	/* text bytes per record, with the '\0' */
+#define LOG_RECORDS	128	/* must be a power of 2 */
+
+/* printk's without a loglevel use this.. */
+#define DEFAULT_MESSAGE_LOGLEVEL 4 /* KERN_WARNING */
+
+/* We show everything that is MORE important than this.. */
+#define DEFAULT_CONSOLE_LOGLEVEL 7 /* anything MORE serious than KERN_DEBUG */
+
+int console_loglevel = DEFAULT_CONSOLE_LOGLEVEL;
+
+/*
+ * One record per printk() call, a printk() without '\n' continues the
+ * line of the next one. ->state is 2*seq while the record is being
+ * filled in and 2*seq+1 once it is complete. Readers check it before
+ * and after copying the record out, like a seqcount, since a writer
+ * LOG_RECORDS records ahead can take the slot over at any time.
+ * ->lost is 1 + the newest seq that had to give the slot up, see
+ * log_claim().
+ */
+struct log_record {
+	volatile unsigned long state;
+	volatile unsigned long lost;
+	unsigned long long ts;		/* TSC when it was logged */
+	unsigned char level;		/* KERN_* */
+	unsigned short len;		/* strlen(text) */
+	char text[LOG_LINE_MAX];
+};
+
+/*
+ * Not static: after a panic the log can be read from the debugger,
+ * see "dmesg" in script/gdbinit.
+ */
+struct log_record log_buf[LOG_RECORDS];
+
+/* next sequence number to hand out; the record lives at seq % LOG_RECORDS */
+atomic_t log_next_seq = ATOMIC_INIT(0);
+
+/* the first record the consoles haven't seen, only touched under the console lock */
+static unsigned long console_seq;
+static volatile int console_locked;
+
+struct console *console_drivers;
+
+static unsigned long long log_time(void)
+{
+	unsigned long long t = 0;
+
+	if (cpu_has_tsc)
+		rdtscll(t);
+	return t;
+}
+
+/* seq's record is gone: given up by its writer, or a lap behind */
+static int log_lost(struct log_record *r, unsigned long seq)
+{
+	return (long)(r->lost - seq) > 0 ||
+	       atomic_read(&log_next_seq) - seq > LOG_RECORDS;
+}
+
+static void log_mark_lost(struct log_record *r, unsigned long seq)
+{
+	unsigned long lost;
+
+	do {
+		lost = r->lost;
+		if ((long)(lost - (seq + 1)) >= 0)
+			return;
+	} while (cmpxchg(&r->lost, lost, seq + 1) != lost);
+}
+
+/*
+ * Take the slot for @seq. A writer can be held up for a whole lap
+ * between reserving its seq and getting here (another CPU logging, or
+ * interrupts), so the slot is only taken over from a complete record
+ * of an older lap. If a newer record is there already ours is simply
+ * dropped. If an older writer is still filling its record in, ours is
+ * dropped as well, marked lost so the consoles don't wait for it.
+ * Slots nobody has used yet are 0.
+ */
+static int log_claim(struct log_record *r, unsigned long seq)
+{
+	unsigned long state;
+
+	do {
+		state = r->state;
+		if (state == 0 && seq < LOG_RECORDS)
+			continue;
+		if ((long)(state - 2 * seq) >= 0)
+			return 0;
+		if (!(state & 1)) {
+			log_mark_lost(r, seq);
+			return 0;
+		}
+	} while (cmpxchg(&r->state, state, 2 * seq) != state);
+	return 1;
+}
+
+/*
+ * Reserve the next record with a single xadd, no lock is taken and
+ * writers on other CPUs or in interrupts each get their own slot.
+ */
+static void log_store(const char *fmt, va_list args)
+{
+	struct log_record *r;
+	unsigned long seq;
+	int level = DEFAULT_MESSAGE_LOGLEVEL;
+	int len;
+
+	// 以 "<n>" 开头的是 KERN_* 级别，不进正文
+	if (fmt[0] == '<' && fmt[1] >= '0' && fmt[1] <= '7' && fmt[2] == '>') {
+		level = fmt[1] - '0';
+		fmt += 3;
+	}
+
+	seq = atomic_inc_return(&log_next_seq) - 1;
+	r = &log_buf[seq & (LOG_RECORDS - 1)];
+	if (!log_claim(r, seq))
+		return;
+	r->ts = log_time();
+	r->level = level;
+	len = vsnprintf(r->text, LOG_LINE_MAX, fmt, args);
+	if (len >= LOG_LINE_MAX)
+		len = LOG_LINE_MAX - 1;		/* cut off */
+	r->len = len;
+	smp_wmb();
+	cmpxchg(&r->state, 2 * seq, 2 * seq + 1);
+}
+
+/*
+ * Copy record @seq to @buf (LOG_LINE_MAX bytes). Returns the text
+ * length, -1 if the record isn't complete yet (or not even reserved)
+ * and -2 if it has been overwritten already or will never be written.
+ */
+static int log_read(unsigned long seq, char *buf, int *level)
+{
+	struct log_record *r = &log_buf[seq & (LOG_RECORDS - 1)];
+	unsigned long state = r->state;
+	int len;
+
+	if (state != 2 * seq + 1)
+		return (long)(state - (2 * seq + 1)) > 0 || log_lost(r, seq) ?
+			-2 : -1;
+	smp_rmb();
+	len = r->len;
+	*level = r->level;
+	memcpy(buf, r->text, len);
+	buf[len] = '\0';
+	smp_rmb();
+	if (r->state != state)
+		return -2;
+	return len;
+}
+
+/* is there a complete (or lost) record at @seq? */
+static int log_pending(unsigned long seq)
+{
+	struct log_record *r = &log_buf[seq & (LOG_RECORDS - 1)];
+
+	return (long)(r->state - 2 * seq) > 0 || log_lost(r, seq);
+}
+
+/* the oldest record that is still in the buffer */
+static unsigned long log_first_seq(void)
+{
+	unsigned long next = atomic_read(&log_next_seq);
+
+	return next > LOG_RECORDS ? next - LOG_RECORDS : 0;
+}
+
+static void call_console_drivers(const char *text, int len)
+{
+	struct console *con;
+
+	for (con = console_drivers; con; con = con->next)
+		if (con->flags & CON_ENABLED)
+			con->write(con, text, len);
+}
+
+/*
+ * Write out every complete record the consoles haven't seen yet.
+ * Called with the console lock held.
+ */
+static void console_drain(void)
+{
+	static char text[LOG_LINE_MAX];
+	int len, level;
+
+	for (;;) {
+		len = log_read(console_seq, text, &level);
+		if (len == -1)
+			break;
+		if (len == -2) {
+			// 控制台落后了一整圈，最老的记录已经被覆盖；
+			// 或者只是这一条被写者放弃了
+			unsigned long first = log_first_seq();
+
+			if ((long)(first - console_seq) <= 0)
+				first = console_seq + 1;
+
+			len = snprintf(text, LOG_LINE_MAX,
+				       "** %lu printk messages dropped **\n",
+				       first - console_seq);
+			console_seq = first;
+			call_console_drivers(text, len);
+			continue;
+		}
+		console_seq++;
+		if (level < console_loglevel)
+			call_console_drivers(text, len);
+	}
+}
+
+int console_trylock(void)
+{
+	return !xchg(&console_locked, 1);
+}
+
+/*
+ * Print what's pending and drop the console lock. A printk() that
+ * completed its record but found the lock taken relies on us to print
+ * it, so look again once the lock is free.
+ */
+void console_unlock(void)
+{
+again:
+	console_drain();
+	xchg(&console_locked, 0);
+	if (log_pending(console_seq) && console_trylock())
+		goto again;
+}
+
+/* Flush whatever printk_deferred() left behind, if the consoles are free */
+void console_flush(void)
+{
+	if (log_pending(console_seq) && console_trylock())
+		console_unlock();
+}
+
+/*
+ * Nobody else is going to run anymore: take the console lock even if
+ * the CPU died while holding it and print all that is left.
+ */
+void console_flush_on_panic(void)
+{
+	console_locked = 1;
+	console_unlock();
+}
+
+void printk(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	log_store(fmt, args);
+	va_end(args);
+
+	if (console_trylock())
+		console_unlock();
+}
+
+/*
+ * For hot paths: only log the message, console_flush() (from the idle
+ * loop) or the next printk() writes it out.
+ */
+void printk_deferred(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	log_store(fmt, args);
+	va_end(args);
+}
+
+/*
+ * The console driver calls this routine during kernel initialization
+ * to register the console printing procedure with printk() and to
+ * print any messages that were printed by the kernel before the
+ * console driver was initialized. The replay only goes to the new
+ * console, the others have seen those records already.
+ */
+void register_console(struct console *console)
+{
+	static char text[LOG_LINE_MAX];
+	unsigned long seq;
+	int len, level;
+
+	while (!console_trylock())
+		cpu_relax();
+
+	if (console->flags & CON_PRINTBUFFER) {
+		for (seq = log_first_seq(); seq != console_seq; seq++) {
+			len = log_read(seq, text, &level);
+			if (len >= 0 && level < console_loglevel)
+				console->write(console, text, len);
+		}
+	}
+	console->flags |= CON_ENABLED;
+	console->next = console_drivers;
+	console_drivers = console;
+
+	console_unlock();
+}
+
+int unregister_console(struct console *console)
+{
+	struct console **p;
+	int res = 1;
+
+	while (!console_trylock())
+		cpu_relax();
+	for (p = &console_drivers; *p; p = &(*p)->next) {
+		if (*p == console) {
+			*p = console->next;
+			res = 0;
+			break;
+		}
+	}
+	console_unlock();
+	return res;
+}
+
+/*
+ * Set up the consoles. Called first thing in start_kernel(), anything
+ * printed before still reaches them through the replay.
+ */
+void __init console_init(void)
+{
+	vga_console_init();
+	serial_console_init();
+}
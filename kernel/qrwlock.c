@@ -0,0 +1,89 @@
+/*
+ *  linux/kernel/qrwlock.c
+ *
+ *  The slow paths of the queued rwlock (see asm/spinlock.h).
+ *
+ *  Whoever can't have the lock right away queues up on the lock's
+ *  wait_lock, a ticket lock, so readers and writers are served in the
+ *  order they came. The head of that queue is the only one waiting on
+ *  the lock word itself.
+ */
+
+#include <linux/kernel.h>
+#include <linux/spinlock.h>
+#include <asm/processor.h>
+#include <asm/system.h>
+
+#ifdef CONFIG_SMP
+
+/*
+ * Wait for the writer holding the lock to go, our reader count is in
+ * already. A writer that is only waiting doesn't hold us up: it can't
+ * set _QW_LOCKED while there are readers.
+ */
+static inline void rspin_until_writer_unlock(rwlock_t *lock,
+					     unsigned int cnts)
+{
+	while ((cnts & _QW_WMASK) == _QW_LOCKED) {
+		cpu_relax();
+		cnts = atomic_read(&lock->cnts);
+	}
+}
+
+/*
+ * The fast path has counted us in, @cnts is the lock word it got back.
+ * The wait_lock is taken raw, it isn't a lock of its own to count.
+ */
+void queued_read_lock_slowpath(rwlock_t *lock, unsigned int cnts)
+{
+	unsigned long flags;
+
+	__save_flags(flags);
+	if (!(flags & X86_EFLAGS_IF)) {
+		rspin_until_writer_unlock(lock, cnts);
+		return;
+	}
+	atomic_sub(_QR_BIAS, &lock->cnts);
+
+	__ticket_spin_lock(&lock->wait_lock);
+	// 排到队头后再把自己算进去，只等已经拿到锁的写者
+	cnts = atomic_add_return(_QR_BIAS, &lock->cnts);
+	rspin_until_writer_unlock(lock, cnts);
+	__ticket_spin_unlock(&lock->wait_lock);
+}
+
+void queued_write_lock_slowpath(rwlock_t *lock)
+{
+	volatile unsigned char *wmode =
+		(volatile unsigned char *)&lock->cnts.counter;
+
+	__ticket_spin_lock(&lock->wait_lock);
+
+	/* Try to acquire the lock directly if no reader is present */
+	if (!atomic_read(&lock->cnts) &&
+	    cmpxchg(&lock->cnts.counter, 0, _QW_LOCKED) == 0)
+		goto unlock;
+
+	/*
+	 * Set the waiting flag to notify readers that a writer is pending,
+	 * or wait for a previous writer to go away.
+	 */
+	for (;;) {
+		if (!*wmode && cmpxchg(wmode, 0, _QW_WAITING) == 0)
+			break;
+		cpu_relax();
+	}
+
+	/* When no more readers, set the locked flag */
+	for (;;) {
+		if (atomic_read(&lock->cnts) == _QW_WAITING &&
+		    cmpxchg(&lock->cnts.counter, _QW_WAITING,
+			    _QW_LOCKED) == _QW_WAITING)
+			break;
+		cpu_relax();
+	}
+unlock:
+	__ticket_spin_unlock(&lock->wait_lock);
+}
+
+#endif /* CONFIG_SMP */
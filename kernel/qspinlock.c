@@ -0,0 +1,127 @@
+/*
+ *  linux/kernel/qspinlock.c
+ *
+ *  The slow path of the queued spinlock, an MCS lock.
+ *
+ *  A CPU that finds the lock taken queues up with one of its own
+ *  mcs_spinlock nodes, swapping its tail code into the lock word, and
+ *  spins on the node until its predecessor hands the head of the queue
+ *  on. Only the head looks at the lock word, waiting for the locked
+ *  byte to clear. The node is only needed while waiting: once the
+ *  lock is ours it goes back, so locks can be released in any order.
+ *
+ *  A CPU can be queued on up to MAX_NODES locks at a time: one in
+ *  process context and one for each interrupt nested on top of it.
+ */
+
+#include <linux/kernel.h>
+#include <linux/smp.h>
+#include <linux/spinlock.h>
+#include <asm/processor.h>
+#include <asm/system.h>
+
+#ifdef CONFIG_SMP
+
+#define MAX_NODES	4
+
+struct mcs_spinlock {
+	struct mcs_spinlock * volatile next;
+	volatile int locked;	/* 1 if lock acquired */
+	int count;		/* nodes in use, kept in the CPU's first one */
+};
+
+static struct mcs_spinlock mcs_nodes[NR_CPUS][MAX_NODES];
+
+static inline unsigned int encode_tail(int cpu, int idx)
+{
+	return ((cpu + 1) << 2 | idx) << _Q_TAIL_OFFSET;
+}
+
+static inline struct mcs_spinlock *decode_tail(unsigned int tail)
+{
+	int cpu = (tail >> (_Q_TAIL_OFFSET + 2)) - 1;
+	int idx = (tail >> _Q_TAIL_OFFSET) & 3;
+
+	return &mcs_nodes[cpu][idx];
+}
+
+/*
+ * Put @tail in the lock's tail half, return the old lock word's tail.
+ * The locked byte is left alone, the owner may clear it meanwhile.
+ */
+static inline unsigned int xchg_tail(qspinlock_t *lock, unsigned int tail)
+{
+	volatile unsigned short *p = (volatile unsigned short *)&lock->val + 1;
+
+	return (unsigned int)xchg(p, tail >> _Q_TAIL_OFFSET) << _Q_TAIL_OFFSET;
+}
+
+void queued_spin_lock_slowpath(qspinlock_t *lock)
+{
+	struct mcs_spinlock *prev, *next, *node;
+	unsigned int old, tail, val;
+	int idx;
+
+	node = &mcs_nodes[smp_processor_id()][0];
+	idx = node->count++;
+	tail = encode_tail(smp_processor_id(), idx);
+	node += idx;
+	node->locked = 0;
+	node->next = NULL;
+
+	/*
+	 * The lock may have been freed while we got the node ready.
+	 */
+	if (queued_spin_trylock(lock))
+		goto release;
+
+	/*
+	 * Publish our node as the tail. If there was a queue before us,
+	 * link in behind it and wait to be made its head.
+	 */
+	old = xchg_tail(lock, tail);
+	if (old & _Q_TAIL_MASK) {
+		prev = decode_tail(old);
+		prev->next = node;
+		while (!node->locked)
+			cpu_relax();
+	}
+
+	/*
+	 * We're at the head of the queue: wait for the owner to go. Only
+	 * the head may take the lock now, anybody else sees a non-zero
+	 * tail and queues up.
+	 */
+	while ((val = lock->val) & _Q_LOCKED_MASK)
+		cpu_relax();
+
+	/*
+	 * If we are the only one queued, take the lock and empty the
+	 * queue in one go. Otherwise just take it, and pass the head on
+	 * to whoever queued up behind us.
+	 */
+	for (;;) {
+		if ((val & _Q_TAIL_MASK) != tail) {
+			*(volatile unsigned char *)&lock->val = _Q_LOCKED_VAL;
+			break;
+		}
+		old = cmpxchg(&lock->val, val, _Q_LOCKED_VAL);
+		if (old == val)
+			goto release;	/* No contention */
+		val = old;
+	}
+
+	/*
+	 * The next one has swapped its tail in already, but may not
+	 * have linked its node to ours yet.
+	 */
+	while (!(next = node->next))
+		cpu_relax();
+	next->locked = 1;
+
+release:
+	barrier();
+	mcs_nodes[smp_processor_id()][0].count--;
+}
+
+#endif /* CONFIG_SMP */
@@ -0,0 +1,286 @@
+/*
+ *  linux/kernel/tick.c
+ *
+ *  The clocksource and clock event device layer, and the tick.
+ *
+ *  The best clocksource (the TSC) keeps time, the best clock event
+ *  device (the local APIC timer, else the PIT) makes the tick
+ *  interrupt. With a clocksource, the tick is one-shot: jiffies is
+ *  worked out from the clocksource whenever an event comes in, and
+ *  while the CPU is idle the next event is programmed for the next
+ *  timer instead of the next jiffy, so an idle machine sleeps until
+ *  there is something to do. Without one, the device runs periodic
+ *  and every event is one jiffy.
+ */
+
+#include <linux/clockchips.h>
+#include <linux/clocksource.h>
+#include <linux/jiffies.h>
+#include <linux/kernel.h>
+#include <linux/timer.h>
+#include <asm/stdio.h>
+#include <asm/system.h>
+
+static struct clocksource *curr_clocksource;
+static struct clock_event_device *tick_device;
+
+static int tick_oneshot;	/* one-shot events, jiffies from the clocksource */
+static int tick_stopped;	/* idle, the next event is the next timer's */
+
+/*
+ * The clocksource's time when jiffies last moved, on a jiffy boundary.
+ * Written together with jiffies_64, under xtime_lock.
+ */
+static unsigned long long last_jiffy_ns;
+
+/* the jiffy the device is programmed for, if tick_armed */
+static unsigned long tick_next_jiffy;
+static int tick_armed;
+
+void clocksource_register(struct clocksource *cs)
+{
+	if (!curr_clocksource || cs->rating > curr_clocksource->rating)
+		curr_clocksource = cs;
+	printk("Time: %s clocksource has been installed.\n", cs->name);
+}
+
+int clocksource_available(void)
+{
+	return curr_clocksource != NULL;
+}
+
+unsigned long long clocksource_read_ns(void)
+{
+	struct clocksource *cs = curr_clocksource;
+
+	return clocksource_cyc2ns(cs->read(), cs->mult, cs->shift);
+}
+
+/**
+ * clockevent_delta2ns - Convert a latch value (device ticks) to nanoseconds
+ *
+ * @latch:	value to convert
+ * @evt:	pointer to clock event device descriptor
+ *
+ * Math helper, returns latch value converted to nanoseconds (bound checked)
+ */
+unsigned long long clockevent_delta2ns(unsigned long latch,
+				       struct clock_event_device *evt)
+{
+	unsigned long long clc = ((unsigned long long) latch) << evt->shift;
+
+	do_div(clc, evt->mult);
+	if (clc < 1000)
+		clc = 1000;
+	return clc;
+}
+
+/*
+ * Program the device @delta ns from now, clamped to what it can do.
+ * Clamping delta first also keeps delta * mult within 64 bits.
+ */
+static void clockevents_program_event(struct clock_event_device *dev,
+				      unsigned long long delta)
+{
+	unsigned long long clc;
+
+	if (delta > dev->max_delta_ns)
+		delta = dev->max_delta_ns;
+	if (delta < dev->min_delta_ns)
+		delta = dev->min_delta_ns;
+
+	clc = (delta * dev->mult) >> dev->shift;
+	dev->set_next_event((unsigned long) clc, dev);
+}
+
+static void clockevents_set_mode(struct clock_event_device *dev,
+				 enum clock_event_mode mode)
+{
+	if (dev->mode != mode) {
+		dev->set_mode(mode, dev);
+		dev->mode = mode;
+	}
+}
+
+/*
+ * Bring jiffies up to the clocksource. Only whole jiffies are taken
+ * off, last_jiffy_ns stays on a jiffy boundary. Only the tick writes
+ * last_jiffy_ns, it can look at it without the lock; the readers'
+ * sequence is only bumped when jiffies really moves.
+ */
+static void tick_do_update_jiffies(unsigned long long now)
+{
+	unsigned long long ticks;
+
+	if (now < last_jiffy_ns + TICK_NSEC)
+		return;
+	write_seqlock(&xtime_lock);
+	ticks = now - last_jiffy_ns;
+	now -= do_div(ticks, TICK_NSEC);
+	last_jiffy_ns = now;
+	do_timer((unsigned long) ticks);
+	write_sequnlock(&xtime_lock);
+}
+
+/*
+ * Arm the device for jiffy @expires. Under a hypervisor every
+ * reprogramming is a VM exit, so nothing is written when the device
+ * is armed for that jiffy already. Past jiffies fire right away.
+ */
+static void tick_program_jiffy(unsigned long expires)
+{
+	long ticks = expires - jiffies;
+	unsigned long long when, now;
+
+	if (tick_armed && tick_next_jiffy == expires)
+		return;
+
+	when = last_jiffy_ns;
+	if (ticks > 0)
+		when += (unsigned long long) ticks * TICK_NSEC;
+	now = clocksource_read_ns();
+	clockevents_set_mode(tick_device, CLOCK_EVT_MODE_ONESHOT);
+	clockevents_program_event(tick_device, when > now ? when - now : 0);
+	tick_next_jiffy = expires;
+	tick_armed = 1;
+}
+
+/*
+ * Idle: program the device for the next timer, or shut it down if
+ * there is none. The clocksource catches jiffies up on whatever
+ * interrupt comes next.
+ */
+static void tick_program_next_timer(void)
+{
+	unsigned long next = next_timer_interrupt();
+
+	if (next - jiffies >= NEXT_TIMER_MAX_DELTA) {
+		clockevents_set_mode(tick_device, CLOCK_EVT_MODE_SHUTDOWN);
+		tick_armed = 0;
+		return;
+	}
+	tick_program_jiffy(next);
+}
+
+/*
+ * The tick itself, from the event device's interrupt handler.
+ */
+static void tick_handle_event(struct clock_event_device *dev)
+{
+	if (!tick_oneshot) {
+		write_seqlock(&xtime_lock);
+		do_timer(1);
+		write_sequnlock(&xtime_lock);
+		run_timer_list();
+		return;
+	}
+
+	tick_armed = 0;
+	tick_do_update_jiffies(clocksource_read_ns());
+	run_timer_list();
+	// 空闲时只为下一个定时器编程，否则按 jiffy 节拍
+	if (tick_stopped)
+		tick_program_next_timer();
+	else
+		tick_program_jiffy(jiffies + 1);
+}
+
+static void clockevents_handle_noop(struct clock_event_device *dev)
+{
+}
+
+/*
+ * Start the tick on @dev: one-shot if there is a clocksource to keep
+ * jiffies with, periodic otherwise.
+ */
+static void tick_setup_device(struct clock_event_device *dev)
+{
+	dev->event_handler = tick_handle_event;
+	if (curr_clocksource && (dev->features & CLOCK_EVT_FEAT_ONESHOT)) {
+		if (!tick_oneshot) {
+			write_seqlock(&xtime_lock);
+			last_jiffy_ns = clocksource_read_ns();
+			write_sequnlock(&xtime_lock);
+		}
+		tick_oneshot = 1;
+		tick_armed = 0;
+		tick_program_jiffy(jiffies + 1);
+	} else {
+		tick_oneshot = 0;
+		clockevents_set_mode(dev, CLOCK_EVT_MODE_PERIODIC);
+	}
+}
+
+/**
+ * clockevents_register_device - register a clock event device
+ * @dev:	device to register
+ *
+ * The device takes over the tick if it's rated better than the one
+ * doing it now, which is shut down.
+ */
+void clockevents_register_device(struct clock_event_device *dev)
+{
+	unsigned long flags;
+
+	dev->event_handler = clockevents_handle_noop;
+	dev->mode = CLOCK_EVT_MODE_UNUSED;
+	if (tick_device && tick_device->rating >= dev->rating)
+		return;
+
+	local_irq_save(flags);
+	if (tick_device) {
+		tick_device->event_handler = clockevents_handle_noop;
+		clockevents_set_mode(tick_device, CLOCK_EVT_MODE_SHUTDOWN);
+	}
+	tick_device = dev;
+	tick_setup_device(dev);
+	local_irq_restore(flags);
+	printk("Time: %s clockevent device, %s tick.\n", dev->name,
+	       tick_oneshot ? "one-shot" : "periodic");
+}
+
+/**
+ * tick_nohz_idle_enter - stop the idle tick
+ *
+ * Called with interrupts off right before halting, so that no timer
+ * can be added between looking for the next one and the halt.
+ */
+void tick_nohz_idle_enter(void)
+{
+	if (!tick_oneshot)
+		return;
+
+	tick_do_update_jiffies(clocksource_read_ns());
+	tick_stopped = 1;
+	tick_program_next_timer();
+}
+
+/*
+ * An interrupt came in while the tick was stopped, jiffies may be
+ * many ticks behind. Bring it up to date before the handlers use it.
+ */
+void tick_irq_enter(void)
+{
+	if (tick_stopped)
+		tick_do_update_jiffies(clocksource_read_ns());
+}
+
+/**
+ * tick_nohz_idle_exit - restart the idle tick
+ *
+ * Called after the halt was interrupted: bring jiffies up to date and
+ * tick again every jiffy while there is work.
+ */
+void tick_nohz_idle_exit(void)
+{
+	unsigned long flags;
+
+	if (!tick_oneshot)
+		return;
+
+	local_irq_save(flags);
+	tick_stopped = 0;
+	tick_do_update_jiffies(clocksource_read_ns());
+	tick_program_jiffy(jiffies + 1);
+	local_irq_restore(flags);
+}
@@ -0,0 +1,316 @@
+/*
+ *  linux/kernel/timer.c
+ *
+ *  Kernel internal timers.
+ *
+ *  Copyright (C) 1991, 1992  Linus Torvalds
+ *
+ *  1997-01-28  Modified by Finn Arne Gangstad to make timers scale better.
+ *
+ *  Timers live in a hierarchical wheel: tv1 has one list per jiffy for
+ *  the next 256 jiffies, tv2..tv5 have 64 lists each, every slot of
+ *  a level covering a whole turn of the level below. Adding or
+ *  deleting a timer is a list operation on the slot its expiry hashes
+ *  to, whatever the number of timers. Once per turn of a level, the
+ *  next slot of the level above is cascaded down into it.
+ */
+
+#include <linux/jiffies.h>
+#include <linux/kernel.h>
+#include <linux/seqlock.h>
+#include <linux/spinlock.h>
+#include <linux/timer.h>
+#include <asm/stdio.h>
+#include <asm/system.h>
+
+/*
+ * The tick count. jiffies is its low word, the linker script puts
+ * the two at the same address: a 32-bit read of jiffies needs no
+ * lock, a read of all 64 bits goes through get_jiffies_64().
+ */
+u64 jiffies_64;
+
+/*
+ * The timekeeping state: jiffies_64 and the time of its last update
+ * (tick.c's last_jiffy_ns). Only the tick writes it, anybody may
+ * read it without writing a shared cache line.
+ */
+seqlock_t xtime_lock = SEQLOCK_UNLOCKED;
+
+u64 get_jiffies_64(void)
+{
+	unsigned long seq;
+	u64 ret;
+
+	do {
+		seq = read_seqbegin(&xtime_lock);
+		ret = jiffies_64;
+	} while (read_seqretry(&xtime_lock, seq));
+	return ret;
+}
+
+/*
+ * Event timer code
+ */
+#define TVN_BITS 6
+#define TVR_BITS 8
+#define TVN_SIZE (1 << TVN_BITS)
+#define TVR_SIZE (1 << TVR_BITS)
+#define TVN_MASK (TVN_SIZE - 1)
+#define TVR_MASK (TVR_SIZE - 1)
+
+struct timer_vec {
+	int index;
+	struct list_head vec[TVN_SIZE];
+};
+
+struct timer_vec_root {
+	int index;
+	struct list_head vec[TVR_SIZE];
+};
+
+static struct timer_vec tv5;
+static struct timer_vec tv4;
+static struct timer_vec tv3;
+static struct timer_vec tv2;
+static struct timer_vec_root tv1;
+
+static struct timer_vec * const tvecs[] = {
+	(struct timer_vec *)&tv1, &tv2, &tv3, &tv4, &tv5
+};
+
+#define NOOF_TVECS (sizeof(tvecs) / sizeof(tvecs[0]))
+
+void init_timervecs (void)
+{
+	int i;
+
+	for (i = 0; i < TVN_SIZE; i++) {
+		INIT_LIST_HEAD(tv5.vec + i);
+		INIT_LIST_HEAD(tv4.vec + i);
+		INIT_LIST_HEAD(tv3.vec + i);
+		INIT_LIST_HEAD(tv2.vec + i);
+	}
+	for (i = 0; i < TVR_SIZE; i++)
+		INIT_LIST_HEAD(tv1.vec + i);
+}
+
+/* the jiffy run_timer_list() is going to run next, tv1.index's */
+static unsigned long timer_jiffies;
+
+static inline void internal_add_timer(struct timer_list *timer)
+{
+	/*
+	 * must be cli-ed when calling this
+	 */
+	unsigned long expires = timer->expires;
+	unsigned long idx = expires - timer_jiffies;
+	struct list_head * vec;
+
+	if (idx < TVR_SIZE) {
+		int i = expires & TVR_MASK;
+		vec = tv1.vec + i;
+	} else if (idx < 1 << (TVR_BITS + TVN_BITS)) {
+		int i = (expires >> TVR_BITS) & TVN_MASK;
+		vec = tv2.vec + i;
+	} else if (idx < 1 << (TVR_BITS + 2 * TVN_BITS)) {
+		int i = (expires >> (TVR_BITS + TVN_BITS)) & TVN_MASK;
+		vec =  tv3.vec + i;
+	} else if (idx < 1 << (TVR_BITS + 3 * TVN_BITS)) {
+		int i = (expires >> (TVR_BITS + 2 * TVN_BITS)) & TVN_MASK;
+		vec = tv4.vec + i;
+	} else if ((signed long) idx < 0) {
+		/* can happen if you add a timer with expires == jiffies,
+		 * or you set a timer to go off in the past
+		 */
+		vec = tv1.vec + tv1.index;
+	} else {
+		int i = (expires >> (TVR_BITS + 3 * TVN_BITS)) & TVN_MASK;
+		vec = tv5.vec + i;
+	}
+	/*
+	 * Timers are FIFO!
+	 */
+	list_add(&timer->list, vec->prev);
+}
+
+/* Initialize both explicitly - let's try to have them in the same cache line */
+spinlock_t timerlist_lock = SPIN_LOCK_UNLOCKED;
+
+void add_timer(struct timer_list *timer)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&timerlist_lock, flags);
+	if (timer_pending(timer))
+		goto bug;
+	internal_add_timer(timer);
+	spin_unlock_irqrestore(&timerlist_lock, flags);
+	return;
+bug:
+	spin_unlock_irqrestore(&timerlist_lock, flags);
+	printk("bug: kernel timer added twice at %p.\n",
+			__builtin_return_address(0));
+}
+
+static inline int detach_timer (struct timer_list *timer)
+{
+	if (!timer_pending(timer))
+		return 0;
+	list_del(&timer->list);
+	return 1;
+}
+
+int mod_timer(struct timer_list *timer, unsigned long expires)
+{
+	int ret;
+	unsigned long flags;
+
+	spin_lock_irqsave(&timerlist_lock, flags);
+	timer->expires = expires;
+	ret = detach_timer(timer);
+	internal_add_timer(timer);
+	spin_unlock_irqrestore(&timerlist_lock, flags);
+	return ret;
+}
+
+int del_timer(struct timer_list * timer)
+{
+	int ret;
+	unsigned long flags;
+
+	spin_lock_irqsave(&timerlist_lock, flags);
+	ret = detach_timer(timer);
+	timer->list.next = timer->list.prev = NULL;
+	spin_unlock_irqrestore(&timerlist_lock, flags);
+	return ret;
+}
+
+static inline void cascade_timers(struct timer_vec *tv)
+{
+	/* cascade all the timers from tv up one level */
+	struct list_head *head, *curr, *next;
+
+	head = tv->vec + tv->index;
+	curr = head->next;
+	/*
+	 * We are removing _all_ timers from the list, so we don't  have to
+	 * detach them individually, just clear the list afterwards.
+	 */
+	while (curr != head) {
+		struct timer_list *tmp;
+
+		tmp = list_entry(curr, struct timer_list, list);
+		next = curr->next;
+		internal_add_timer(tmp);
+		curr = next;
+	}
+	INIT_LIST_HEAD(head);
+	tv->index = (tv->index + 1) & TVN_MASK;
+}
+
+/*
+ * Run every timer that is due, one jiffy at a time, up to the current
+ * jiffies. After a tickless stretch of idle that is many jiffies at
+ * once. The handlers run with the lock dropped, they may add timers
+ * or re-arm their own.
+ */
+void run_timer_list(void)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&timerlist_lock, flags);
+	while ((long)(jiffies - timer_jiffies) >= 0) {
+		struct list_head *head, *curr;
+		if (!tv1.index) {
+			int n = 1;
+			do {
+				cascade_timers(tvecs[n]);
+			} while (tvecs[n]->index == 1 && ++n < NOOF_TVECS);
+		}
+repeat:
+		head = tv1.vec + tv1.index;
+		curr = head->next;
+		if (curr != head) {
+			struct timer_list *timer;
+			void (*fn)(unsigned long);
+			unsigned long data;
+
+			timer = list_entry(curr, struct timer_list, list);
+ 			fn = timer->function;
+ 			data= timer->data;
+
+			detach_timer(timer);
+			timer->list.next = timer->list.prev = NULL;
+			spin_unlock_irqrestore(&timerlist_lock, flags);
+			fn(data);
+			spin_lock_irqsave(&timerlist_lock, flags);
+			goto repeat;
+		}
+		++timer_jiffies;
+		tv1.index = (tv1.index + 1) & TVR_MASK;
+	}
+	spin_unlock_irqrestore(&timerlist_lock, flags);
+}
+
+/*
+ * The earliest expiry among the timers of the first non-empty slot
+ * of tv, looking from the slot that is cascaded next. The slots after
+ * it only hold later timers.
+ */
+static int next_in_vec(struct list_head *vec, int index, int size,
+		       unsigned long *expires)
+{
+	struct list_head *head, *curr;
+	int i, found = 0;
+
+	for (i = 0; i < size; i++) {
+		head = vec + ((index + i) & (size - 1));
+		list_for_each(curr, head) {
+			struct timer_list *timer;
+
+			timer = list_entry(curr, struct timer_list, list);
+			if (!found || time_before(timer->expires, *expires))
+				*expires = timer->expires;
+			found = 1;
+		}
+		if (found)
+			return 1;
+	}
+	return 0;
+}
+
+/*
+ * The jiffy the next timer is due at, for the tickless idle code. A
+ * level's timers can be due before those of the level below (they
+ * are only cascaded down when that level wraps), so every level's
+ * first slot is looked at. NEXT_TIMER_MAX_DELTA away if there are no
+ * timers at all.
+ */
+unsigned long next_timer_interrupt(void)
+{
+	unsigned long next = jiffies + NEXT_TIMER_MAX_DELTA;
+	unsigned long expires, flags;
+	int n;
+
+	spin_lock_irqsave(&timerlist_lock, flags);
+	// tv1 每个槽只对应一个 jiffy，找到的第一个就是 tv1 里最早的
+	if (next_in_vec(tv1.vec, tv1.index, TVR_SIZE, &expires))
+		next = expires;
+	for (n = 1; n < NOOF_TVECS; n++) {
+		if (next_in_vec(tvecs[n]->vec, tvecs[n]->index, TVN_SIZE,
+				&expires) && time_before(expires, next))
+			next = expires;
+	}
+	spin_unlock_irqrestore(&timerlist_lock, flags);
+	return next;
+}
+
+/*
+ * Advance jiffies. ticks is more than one when the tick was off while
+ * idle, or a tick got lost. Called with xtime_lock held for writing.
+ */
+void do_timer(unsigned long ticks)
+{
+	jiffies_64 += ticks;
+}
@@ -0,0 +1,174 @@
+/*
+ * lib/bitmap.c
+ * Helper functions for bitmap.h.
+ *
+ * Range operations work a word at a time: the partial first and last
+ * words are masked, everything in between is filled with rep stosl,
+ * or with 16-byte SSE2 stores for long runs when the CPU has them.
+ * None of this is atomic, callers serialize access to the bitmap.
+ */
+#include <linux/bitmap.h>
+#include <asm/processor.h>
+#include <asm/xmm.h>
+
+/* Below this many whole words rep stosl beats setting up SSE2 */
+#define BITMAP_SSE2_WORDS	128
+
+/*
+ * Fill @nr words at @p with @val.
+ *
+ * The SSE2 loop saves %xmm0 and puts it back: it may have interrupted
+ * another SSE2 fill or copy on this CPU (see asm/xmm.h).
+ */
+static void bitmap_fill_words(unsigned long *p, unsigned long val, unsigned long nr)
+{
+	int d0, d1;
+
+	if (nr >= BITMAP_SSE2_WORDS && cpu_has_xmm2) {
+		struct xmm_save xmm;
+		unsigned long blocks;
+
+		// 先按字填充到 16 字节对齐
+		while ((unsigned long)p & 15) {
+			*p++ = val;
+			nr--;
+		}
+		blocks = nr / 16;	// 每次循环写 64 字节
+		nr %= 16;
+		kernel_xmm_begin(&xmm, 1);
+		__asm__ __volatile__(
+			"movd %4, %%xmm0\n\t"
+			"pshufd $0, %%xmm0, %%xmm0\n"
+			"1:\tmovdqa %%xmm0, (%0)\n\t"
+			"movdqa %%xmm0, 16(%0)\n\t"
+			"movdqa %%xmm0, 32(%0)\n\t"
+			"movdqa %%xmm0, 48(%0)\n\t"
+			"addl $64, %0\n\t"
+			"decl %1\n\t"
+			"jnz 1b"
+			: "=r" (p), "=r" (d0)
+			: "0" (p), "1" (blocks), "r" (val)
+			: "memory");
+		kernel_xmm_end(&xmm, 1);
+	}
+	if (nr)
+		__asm__ __volatile__(
+			"rep ; stosl"
+			: "=&c" (d0), "=&D" (d1)
+			: "a" (val), "0" (nr), "1" (p)
+			: "memory");
+}
+
+/**
+ * bitmap_set - set a range of bits
+ * @map: the bitmap
+ * @start: first bit to set
+ * @nr: number of bits to set
+ */
+void bitmap_set(unsigned long *map, unsigned long start, unsigned long nr)
+{
+	unsigned long *p = map + BIT_WORD(start);
+	unsigned long end = start + nr;
+	unsigned long words;
+
+	if (!nr)
+		return;
+	if (BIT_WORD(start) == BIT_WORD(end - 1)) {
+		/* the whole range is inside one word */
+		*p |= BITMAP_FIRST_WORD_MASK(start) & BITMAP_LAST_WORD_MASK(end);
+		return;
+	}
+
+	*p++ |= BITMAP_FIRST_WORD_MASK(start);
+	words = BIT_WORD(end) - BIT_WORD(start) - 1;
+	bitmap_fill_words(p, ~0UL, words);
+	p += words;
+	if (end % BITS_PER_LONG)
+		*p |= BITMAP_LAST_WORD_MASK(end);
+}
+
+/**
+ * bitmap_clear - clear a range of bits
+ * @map: the bitmap
+ * @start: first bit to clear
+ * @nr: number of bits to clear
+ */
+void bitmap_clear(unsigned long *map, unsigned long start, unsigned long nr)
+{
+	unsigned long *p = map + BIT_WORD(start);
+	unsigned long end = start + nr;
+	unsigned long words;
+
+	if (!nr)
+		return;
+	if (BIT_WORD(start) == BIT_WORD(end - 1)) {
+		*p &= ~(BITMAP_FIRST_WORD_MASK(start) & BITMAP_LAST_WORD_MASK(end));
+		return;
+	}
+
+	*p++ &= ~BITMAP_FIRST_WORD_MASK(start);
+	words = BIT_WORD(end) - BIT_WORD(start) - 1;
+	bitmap_fill_words(p, 0UL, words);
+	p += words;
+	if (end % BITS_PER_LONG)
+		*p &= ~BITMAP_LAST_WORD_MASK(end);
+}
+
+/**
+ * bitmap_weight - count the set bits in the first @nbits of a bitmap
+ * @bitmap: the bitmap
+ * @nbits: number of bits to look at
+ */
+unsigned long bitmap_weight(const unsigned long *bitmap, unsigned long nbits)
+{
+	unsigned long k, lim = nbits / BITS_PER_LONG, w = 0;
+
+	for (k = 0; k < lim; k++)
+		w += hweight32(bitmap[k]);
+
+	if (nbits % BITS_PER_LONG)
+		w += hweight32(bitmap[k] & BITMAP_LAST_WORD_MASK(nbits));
+
+	return w;
+}
+
+/**
+ * bitmap_find_next_zero_area_off - find a contiguous aligned zero area
+ * @map: The address to base the search on
+ * @size: The bitmap size in bits
+ * @start: The bitnumber to start searching at
+ * @nr: The number of zeroed bits we're looking for
+ * @align_mask: Alignment mask for zero area
+ * @align_offset: Alignment offset for zero area.
+ *
+ * The @align_mask should be one less than a power of 2; the effect is that
+ * the bit offset of all zero areas this function finds plus @align_offset
+ * is multiple of that power of 2.
+ *
+ * Returns a value > @size - @nr if no such area exists.
+ */
+unsigned long bitmap_find_next_zero_area_off(unsigned long *map,
+					     unsigned long size,
+					     unsigned long start,
+					     unsigned long nr,
+					     unsigned long align_mask,
+					     unsigned long align_offset)
+{
+	unsigned long index, end, i;
+again:
+	index = find_next_zero_bit(map, size, start);
+
+	/* Align allocation */
+	index = ((index + align_offset + align_mask) & ~align_mask) - align_offset;
+
+	end = index + nr;
+	if (end > size)
+		return end;
+	// 整字检查 [index, end) 中是否有被占用的位
+	i = find_next_bit(map, end, index);
+	if (i < end) {
+		start = i + 1;
+		goto again;
+	}
+	return index;
+}
@@ -1,5 +1,7 @@
 #include <asm/io.h>
 #include <asm/stdio.h>
+#include <linux/console.h>
+#include <linux/init.h>
 #include <linux/string.h>
 
 /*
@@ -41,17 +43,30 @@ MAKE_COLOR(BLACK, RED) | BRIGHT | FLASH
 // 颜色视频内存的基址
 #define V_MEM_BASE DISPLAY_VRAM /* base of color video memory */
 
-// 用于屏幕滚动的方向
-#define SCREEN_UP -1
-#define SCREEN_DOWN 1
+// 彩色文本模式的显存窗口 0xb8000-0xbffff，共 32KB，远大于一屏的 4000 字节
+#define V_MEM_SIZE 0x8000
+#define V_MEM_CELLS (V_MEM_SIZE / 2)
 
 // VGA文本模式的屏幕宽度和高度（以字符为单位）
 #define SCREEN_WIDTH 80
 #define SCREEN_HEIGHT 25
+#define SCREEN_CELLS (SCREEN_WIDTH * SCREEN_HEIGHT)
 
 // 默认颜色: 黑色背景与白色前景
 #define COLOR_DEFAULT (MAKE_COLOR(TEXT_BLACK, TEXT_WHITE))
 
+// 显存中的一个字符单元：低字节是字符，高字节是颜色
+#define VGA_CELL(ch) ((unsigned short)((COLOR_DEFAULT << 8) | (unsigned char)(ch)))
+#define VGA_BLANK VGA_CELL(' ')
+
+static unsigned short *const vga_vram = (unsigned short *)V_MEM_BASE;
+
+// 屏幕左上角在显存中的单元偏移，滚屏只是把它往后移一行
+static unsigned int vga_origin;
+// 最后一次写进 CRTC 的起始地址和光标位置，没变就不再写端口
+static unsigned int vga_hw_origin, vga_hw_cursor;
+
+// 光标在屏幕上的位置（相对 vga_origin）
 int cursor_x = 0, cursor_y = 0;
 
 void outsb(unsigned short port, const void *addr, unsigned long count) {
@@ -155,117 +170,160 @@ void outl_p(unsigned int value, unsigned short port) {
                        : "a"(value), "Nd"(port));
 }
 
-static void set_cursor(unsigned short cursor) {
-  // 设置光标位置 0-2000
-  outb(CURSOR_H, CRTC_ADDR_REG);  // 光标高位
-  outb((cursor >> 8) & 0xFF, CRTC_DATA_REG);
-  outb(CURSOR_L, CRTC_ADDR_REG);  // 光标低位
-  outb(cursor & 0xFF, CRTC_DATA_REG);
+/*
+ * Port I/O is what's expensive here, especially under a hypervisor
+ * where every access traps. One outw sets a CRTC register: the low byte
+ * goes to the index port, the high byte to the data port next to it.
+ */
+static void crtc_write(unsigned char reg, unsigned short val) {
+  outw((val & 0xff00) | reg, CRTC_ADDR_REG);    // reg 是高 8 位
+  outw((val << 8) | (reg + 1), CRTC_ADDR_REG);  // reg + 1 是低 8 位
 }
 
 /**
- * flush - 刷新光标和起始位置
- * @console: 控制台
+ * vga_update - 把起始地址和光标同步到 CRTC
+ *
+ * 只在一次输出结束时调用，而且只写变化了的寄存器。
  */
-static void flush() {
-  /* 计算光标位置，并设置 */
-  set_cursor(cursor_y * SCREEN_WIDTH + cursor_x);
+static void vga_update(void) {
+  unsigned int cursor = vga_origin + cursor_y * SCREEN_WIDTH + cursor_x;
+
+  if (vga_origin != vga_hw_origin) {
+    vga_hw_origin = vga_origin;
+    crtc_write(START_ADDR_H, vga_origin);
+  }
+  if (cursor != vga_hw_cursor) {
+    vga_hw_cursor = cursor;
+    crtc_write(CURSOR_H, cursor);
+  }
+}
+
+static void scr_memsetw(unsigned short *s, unsigned short c, unsigned count) {
+  int d0, d1;
+  __asm__ __volatile__("cld\n\trep ; stosw"
+                       : "=&c"(d0), "=&D"(d1)
+                       : "a"(c), "0"(count), "1"(s)
+                       : "memory");
 }
 
 /**
- * scroll_sceen - 滚屏
- * @console: 控制台
- * @direction: 滚动方向
- *             - SCREEN_UP: 向上滚动
- *             - SCREEN_DOWN: 向下滚动
+ * vga_scroll - 向上滚动一行
  *
+ * 只是把屏幕的起点在显存窗口里后移一行，旧的内容不用搬。
+ * 到了窗口末尾才把当前屏幕的下面 24 行复制回窗口开头，
+ * 32KB 的窗口大约每 180 行才复制一次。
  */
-static void scroll_sceen(int direction) {
-  unsigned char *vram = (unsigned char *)(V_MEM_BASE);
-  int i;
-
-  if (direction == SCREEN_UP) {
-    /* 起始地址 */
-    for (i = SCREEN_WIDTH * 2 * 24; i > SCREEN_WIDTH * 2; i -= 2) {
-      vram[i] = vram[i - SCREEN_WIDTH * 2];
-      vram[i + 1] = vram[i + 1 - SCREEN_WIDTH * 2];
-    }
-    for (i = 0; i < SCREEN_WIDTH * 2; i += 2) {
-      vram[i] = '\0';
-      vram[i + 1] = COLOR_DEFAULT;
-    }
-
-  } else if (direction == SCREEN_DOWN) {
-    /* 起始地址 */
-    for (i = 0; i < SCREEN_WIDTH * 2 * 24; i += 2) {
-      vram[i] = vram[i + SCREEN_WIDTH * 2];
-      vram[i + 1] = vram[i + 1 + SCREEN_WIDTH * 2];
-    }
-    for (i = SCREEN_WIDTH * 2 * 24; i < SCREEN_WIDTH * 2 * 25; i += 2) {
-      vram[i] = '\0';
-      vram[i + 1] = COLOR_DEFAULT;
-    }
-    cursor_y--;
+static void vga_scroll(void) {
+  if (vga_origin + SCREEN_CELLS + SCREEN_WIDTH > V_MEM_CELLS) {
+    memcpy(vga_vram, vga_vram + vga_origin + SCREEN_WIDTH,
+           (SCREEN_CELLS - SCREEN_WIDTH) * 2);
+    vga_origin = 0;
+  } else {
+    vga_origin += SCREEN_WIDTH;
   }
-  flush();
+  scr_memsetw(vga_vram + vga_origin + SCREEN_CELLS - SCREEN_WIDTH, VGA_BLANK,
+              SCREEN_WIDTH);
+}
+
+static void vga_newline(void) {
+  cursor_x = 0;
+  if (cursor_y < SCREEN_HEIGHT - 1)
+    cursor_y++;
+  else
+    vga_scroll();
 }
 
 /**
- * put_char - 控制台上输出一个字符
- * @console: 控制台
- * @ch: 字符
+ * vga_puts - 把 @count 个字符写进显存，不碰 CRTC
+ * @s: 字符
+ * @count: 字符数
+ *
+ * 一行之内连续的可打印字符直接按 16 位单元写进去。
  */
-void put_char(char ch) {
-  char *vram = (char *)(V_MEM_BASE + (cursor_y * SCREEN_WIDTH + cursor_x) * 2);
-  switch (ch) {
-    case '\r':
-      break;
-    case '\n':
-      // 如果是回车，那还是要把回车写进去
-      *vram++ = '\0';
-      *vram = COLOR_DEFAULT;
-      cursor_x = 0;
-      cursor_y++;
-
-      break;
-    case '\b':
-      if (cursor_x >= 0 && cursor_y >= 0) {
-        cursor_x--;
-        /* 调整为上一行尾 */
-        if (cursor_x < 0) {
+static void vga_puts(const char *s, unsigned count) {
+  unsigned short *p;
+  unsigned n, room;
+
+  while (count) {
+    switch (*s) {
+      case '\r':
+        break;
+      case '\n':
+        vga_newline();
+        break;
+      case '\b':
+        if (cursor_x > 0) {
+          cursor_x--;
+        } else if (cursor_y > 0) {
+          /* 调整为上一行尾 */
           cursor_x = SCREEN_WIDTH - 1;
           cursor_y--;
-          /* 对y进行修复 */
-          if (cursor_y < 0) cursor_y = 0;
         }
-        *(vram - 2) = '\0';
-        *(vram - 1) = COLOR_DEFAULT;
-      }
-      break;
-    default:
-      *vram++ = ch;
-      *vram = COLOR_DEFAULT;
-
-      cursor_x++;
-      if (cursor_x > SCREEN_WIDTH - 1) {
-        cursor_x = 0;
-        cursor_y++;
-      }
-      break;
-  }
-  /* 滚屏 */
-  while (cursor_y > SCREEN_HEIGHT - 1) {
-    scroll_sceen(SCREEN_DOWN);
+        vga_vram[vga_origin + cursor_y * SCREEN_WIDTH + cursor_x] = VGA_BLANK;
+        break;
+      default:
+        p = vga_vram + vga_origin + cursor_y * SCREEN_WIDTH + cursor_x;
+        room = SCREEN_WIDTH - cursor_x;
+        for (n = 0; n < count && n < room; n++) {
+          if (s[n] == '\n' || s[n] == '\r' || s[n] == '\b')
+            break;
+          p[n] = VGA_CELL(s[n]);
+        }
+        cursor_x += n;
+        if (cursor_x == SCREEN_WIDTH)
+          vga_newline();
+        s += n;
+        count -= n;
+        continue;
+    }
+    s++;
+    count--;
   }
+}
 
-  flush();
+/**
+ * put_char - 控制台上输出一个字符
+ * @ch: 字符
+ */
+void put_char(char ch) {
+  vga_puts(&ch, 1);
+  vga_update();
 }
 
 void print_str(char *str) {
-  while (*str) {
-    put_char(*str);
-    str++;
-  }
+  vga_puts(str, strlen(str));
+  vga_update();
+}
+
+/**
+ * vga_console_write - printk 的 VGA 控制台输出
+ * @co: 控制台
+ * @s: 要输出的文本，不一定以 '\0' 结尾
+ * @count: 字节数
+ */
+static void vga_console_write(struct console *co, const char *s,
+                              unsigned count) {
+  vga_puts(s, count);
+  vga_update();  // 每条 printk 记录只更新一次光标
+}
+
+static struct console vga_console = {
+    .name = "vga",
+    .write = vga_console_write,
+    .flags = CON_PRINTBUFFER,
+    .index = -1,
+};
+
+/*
+ * Start from a clean window with the screen at its top, whatever the
+ * BIOS or the boot loader left there.
+ */
+void __init vga_console_init(void) {
+  scr_memsetw(vga_vram, VGA_BLANK, V_MEM_CELLS);
+  vga_origin = cursor_x = cursor_y = 0;
+  vga_hw_origin = vga_hw_cursor = -1;
+  vga_update();
+  register_console(&vga_console);
 }
 
 void print_int(int num) {
@@ -123,9 +123,20 @@ static int skip_atoi(const char **s) {
 #define LARGE \
   64 /* use 'ABCDEF' instead of 'abcdef' */  // 使用大写字母'ABCDEF'而不是小写字母'abcdef'
 
+/*
+ * 只写入缓冲区以内的字符，超出的部分只推进 str，这样返回值仍是完整输出的长度
+ */
+#define PUTC(c)                \
+  do {                         \
+    char __c = (c);            \
+    if (str < end) *str = __c; \
+    ++str;                     \
+  } while (0)
+
 /**
  * 将数字转换为字符串
  * @str: 目标字符串的指针，用于存储转换后的结果
+ * @end: 缓冲区中最后一个可写的位置（留给结尾的 '\0'），超出的字符只计数不写入
  * @num: 待转换的数值
  * @base: 指定的进制，取值范围为2到36
  * @size: 目标字符串的总长度，包括数值本身和可能的填充字符
@@ -136,8 +147,8 @@ static int skip_atoi(const char **s) {
  *
  * @return: 指向目标字符串末尾的指针
  */
-static char *number(char *str, long long num, int base, int size, int precision,
-                    int type) {
+static char *number(char *str, char *end, long long num, int base, int size,
+                    int precision, int type) {
   char c, sign, tmp[66];
   const char *digits = "0123456789abcdefghijklmnopqrstuvwxyz";
   int i;
@@ -182,38 +193,50 @@ static char *number(char *str, long long num, int base, int size, int precision,
   size -= precision;  // 计算剩余可用空间
   if (!(type & (ZEROPAD +
                 LEFT)))  // 如果不是左对齐且不使用零填充，则在剩余空间前填充空格
-    while (size-- > 0) *str++ = ' ';
-  if (sign) *str++ = sign;  // 存储符号位
+    while (size-- > 0) PUTC(' ');
+  if (sign) PUTC(sign);  // 存储符号位
   if (type & SPECIAL) {
     if (base == 8)  // 如果是8进制数，则存储前缀"0"
-      *str++ = '0';
+      PUTC('0');
     else if (base == 16) {  // 如果是8进制数，则存储前缀"0"
-      *str++ = '0';
-      *str++ = digits[33];
+      PUTC('0');
+      PUTC(digits[33]);
     }
   }
   if (!(type & LEFT))
     while (size-- > 0)  // 在剩余空间前填充指定的字符
-      *str++ = c;
+      PUTC(c);
   while (i < precision--)  // 在字符转换后的数值前填充零，以满足指定的精度
-    *str++ = '0';
+    PUTC('0');
   while (i-- > 0)  // 将字符转换后的数值逆序存储到目标字符串中
-    *str++ = tmp[i];
+    PUTC(tmp[i]);
   while (size-- > 0)  // 在剩余空间后填充空格
-    *str++ = ' ';
+    PUTC(' ');
   return str;  // 返回指向目标字符串末尾的指针
 }
 
 /* Forward decl. needed for IP address printing stuff... */
 int sprintf(char *buf, const char *fmt, ...);
 
-int vsprintf(char *buf, const char *fmt, va_list args) {
+/**
+ * vsnprintf - Format a string and place it in a buffer
+ * @buf: The buffer to place the result into
+ * @size: The size of the buffer, including the trailing null space
+ * @fmt: The format string to use
+ * @args: Arguments for the format string
+ *
+ * The output is cut off at @size - 1 characters and always terminated
+ * (unless @size is 0). Returns the length the whole output would have
+ * had, like C99.
+ */
+int vsnprintf(char *buf, size_t size, const char *fmt, va_list args) {
   int len;
   unsigned long long num;
   int i, base;
   char *str;
   const char *s;
 
+  char *end;
   int flags; /* flags to number() */
 
   int field_width; /* width of output field */  // 输出字段的宽度
@@ -226,9 +249,10 @@ int vsprintf(char *buf, const char *fmt, va_list args) {
   /* 'z' support added 23/7/1999 S.H.    */
   /* 'z' changed to 'Z' --davidm 1/25/99 */
 
+  end = buf + size - 1;
   for (str = buf; *fmt; ++fmt) {
     if (*fmt != '%') {  // 如果当前字符不是 '%'
-      *str++ = *fmt;
+      PUTC(*fmt);
       continue;
     }
     // 处理标志位
@@ -299,9 +323,9 @@ int vsprintf(char *buf, const char *fmt, va_list args) {
     switch (*fmt) {
       case 'c':  // 字符
         if (!(flags & LEFT))
-          while (--field_width > 0) *str++ = ' ';
-        *str++ = (unsigned char)va_arg(args, int);
-        while (--field_width > 0) *str++ = ' ';
+          while (--field_width > 0) PUTC(' ');
+        PUTC((unsigned char)va_arg(args, int));
+        while (--field_width > 0) PUTC(' ');
         continue;
 
       case 's':  // 字符串
@@ -311,9 +335,9 @@ int vsprintf(char *buf, const char *fmt, va_list args) {
         len = strnlen(s, precision);
 
         if (!(flags & LEFT))
-          while (len < field_width--) *str++ = ' ';
-        for (i = 0; i < len; ++i) *str++ = *s++;
-        while (len < field_width--) *str++ = ' ';
+          while (len < field_width--) PUTC(' ');
+        for (i = 0; i < len; ++i) PUTC(*s++);
+        while (len < field_width--) PUTC(' ');
         continue;
 
       case 'p':  // 指针
@@ -321,7 +345,7 @@ int vsprintf(char *buf, const char *fmt, va_list args) {
           field_width = 2 * sizeof(void *);
           flags |= ZEROPAD;  // 补零标志
         }
-        str = number(str, (unsigned long)va_arg(args, void *), 16, field_width,
+        str = number(str, end, (unsigned long)va_arg(args, void *), 16, field_width,
                      precision, flags);  // 将指针转换为字符串
         continue;
 
@@ -339,7 +363,7 @@ int vsprintf(char *buf, const char *fmt, va_list args) {
         continue;
 
       case '%':
-        *str++ = '%';
+        PUTC('%');
         continue;
 
       /* integer number formats - set up the flags and "break" */
@@ -360,10 +384,9 @@ int vsprintf(char *buf, const char *fmt, va_list args) {
         break;
 
       default:  // 未知格式化字符
-        *str++ =
-            '%';  // 遇到未知的格式化字符，则将%字符和后面的字符原样复制到目标缓冲区中
+        PUTC('%');  // 遇到未知的格式化字符，则将%字符和后面的字符原样复制到目标缓冲区中
         if (*fmt)
-          *str++ = *fmt;
+          PUTC(*fmt);
         else
           --fmt;
         continue;
@@ -382,12 +405,28 @@ int vsprintf(char *buf, const char *fmt, va_list args) {
       num = va_arg(args, unsigned int);
       if (flags & SIGN) num = (signed int)num;
     }
-    str = number(str, num, base, field_width, precision, flags);
+    str = number(str, end, num, base, field_width, precision, flags);
   }
-  *str = '\0';
+  if (size > 0)
+    *(str <= end ? str : end) = '\0';
   return str - buf;
 }
 
+int snprintf(char *buf, size_t size, const char *fmt, ...) {
+  va_list args;
+  int i;
+
+  va_start(args, fmt);
+  i = vsnprintf(buf, size, fmt, args);
+  va_end(args);
+  return i;
+}
+
+/* 不限长度：缓冲区一直算到地址空间的末尾 */
+int vsprintf(char *buf, const char *fmt, va_list args) {
+  return vsnprintf(buf, (unsigned long)-1 - (unsigned long)buf, fmt, args);
+}
+
 int sprintf(char *buf, const char *fmt, ...) {
   va_list args;
   int i;
@@ -15,8 +15,12 @@
 #include <asm/io.h>
 #include <linux/string.h>
 #include <linux/debug.h>
-#include <asm/bitops.h>
+#include <linux/bitmap.h>
+#include <linux/mm.h>
+#include <asm/processor.h>
+#include <asm/msr.h>
 #include <asm/stdio.h>
+#include <linux/kernel.h>
 
 /*
  * Access to this subsystem has to be serialized externally. (this is
@@ -26,6 +30,7 @@ unsigned long max_low_pfn;
 unsigned long min_low_pfn;
 unsigned long max_pfn;
 
+#ifndef CONFIG_NO_BOOTMEM
 
 /*
  * Called once to set up the allocator itself.
@@ -48,6 +53,8 @@ static unsigned long __init init_bootmem_core (pg_data_t *pgdat,
 	bdata->node_boot_start = (start << PAGE_SHIFT);	// 记录该节点的起始物理地址 pfn
 	// 记录节点可用内存的最大页帧号
 	bdata->node_low_pfn = end;	// 记录该节点的结束地址 pfn
+	bdata->last_pos = 0;		// 还没有分配过，next-fit 从节点起始处开始
+	bdata->last_offset = 0;
 
 	/*
 	 * Initially all pages are reserved - setup_arch() has to
@@ -93,17 +100,17 @@ static void __init reserve_bootmem_core(bootmem_data_t *bdata, unsigned long add
 		BUG();		// 如果起始索引大于等于结束索引，发出错误警告
 	if (end > bdata->node_low_pfn)
 		BUG();		// 如果起始地址右移PAGE_SHIFT位后大于等于node_low_pfn，发出错误警告
-	for (i = sidx; i < eidx; i++)	// 遍历起始索引到结束索引之间的所有页
-		if (test_and_set_bit(i, bdata->node_bootmem_map))	// 检查并设置位图中的相应位，表示该页已被保留
-			// 如果该位已经被设置，说明该页已经被保留过一次，打印警告消息
-			printk("hm, page %08lx reserved twice.\n", i*PAGE_SIZE);
+	// 整字查找已经被保留过的页，只有它们才需要逐个打印警告
+	for (i = find_next_bit(bdata->node_bootmem_map, eidx, sidx); i < eidx;
+	     i = find_next_bit(bdata->node_bootmem_map, eidx, i + 1))
+		printk("hm, page %08lx reserved twice.\n", i*PAGE_SIZE);
+	bitmap_set(bdata->node_bootmem_map, sidx, eidx - sidx);	// 整字设置位图，表示这些页已被保留
 }
 
 // 接受一个指向 bootmem_data_t 结构体的指针 bdata，以及起始地址 addr 和大小 size 的参数，
 // 表示要释放的内存页的范围。
 static void __init free_bootmem_core(bootmem_data_t *bdata, unsigned long addr, unsigned long size)
 {
-	unsigned long i;
 	unsigned long start;
 	/*
 	 * round down end of usable mem, partially free pages are
@@ -126,13 +133,195 @@ static void __init free_bootmem_core(bootmem_data_t *bdata, unsigned long addr,
 	start = (addr + PAGE_SIZE-1) / PAGE_SIZE;	// 向上舍入到页边界
 	sidx = start - (bdata->node_boot_start/PAGE_SIZE);	// 计算起始索引偏移量
 
-	// 逐个遍历起始索引 sidx 到结束索引 eidx 之间的索引值，对应于要释放的内存页。
-	// 逐个遍历页帧号，释放对应的位图位
-	for (i = sidx; i < eidx; i++) {
-		// 检查并清除位图中的位，如果位图已经被清除或者未被设置，则触发 BUG，表示内部错误
-		if (!test_and_clear_bit(i, bdata->node_bootmem_map))
+	if (sidx >= eidx)
+		return;
+	// 范围内有未被设置的位说明重复释放，触发 BUG，表示内部错误
+	if (find_next_zero_bit(bdata->node_bootmem_map, eidx, sidx) < eidx)
+		BUG();
+	bitmap_clear(bdata->node_bootmem_map, sidx, eidx - sidx);	// 整字清除位图中的位
+}
+
+/*
+ * We 'merge' subsequent allocations to save space. We might 'lose'
+ * some fraction of a page if allocations cannot be satisfied due to
+ * size constraints on boxes where there is physical RAM space
+ * fragmentation - in these cases * (mostly large memory boxes) this
+ * is not a problem.
+ *
+ * On low memory boxes we get it right in 100% of the cases.
+ *
+ * The search is next-fit: it resumes right after the last allocation
+ * (last_pos) instead of walking the bitmap from the start of the node
+ * on every call, and bitmap_find_next_zero_area_off() skips allocated
+ * words instead of testing page by page.
+ * Only if that fails do we wrap around to the goal and then to the
+ * start of the node.
+ *
+ * alignment has to be a power of 2 value.
+ */
+static void * __init __alloc_bootmem_core (bootmem_data_t *bdata, 
+	unsigned long size, unsigned long align, unsigned long goal)
+{
+	unsigned long i, start, limit, align_offset, align_mask;
+	unsigned long eidx, areasize, preferred;
+	unsigned long remaining_size;
+	void *ret;
+
+	if (!size) BUG();
+	if (!align) align = 1;
+	if (align & (align-1))
+		BUG();
+
+	eidx = bdata->node_low_pfn - (bdata->node_boot_start >> PAGE_SHIFT);	// 节点管理的页数
+
+	/*
+	 * Page alignment, relative to the page frame number: the node
+	 * itself does not have to start on an aligned address.
+	 */
+	align_mask = (align >> PAGE_SHIFT ? : 1) - 1;
+	align_offset = (bdata->node_boot_start >> PAGE_SHIFT) & align_mask;
+
+	/*
+	 * We try to allocate bootmem pages above 'goal'
+	 * first, then we try to allocate lower pages.
+	 */
+	preferred = 0;
+	if (goal && (goal >= bdata->node_boot_start) && 
+			((goal >> PAGE_SHIFT) < bdata->node_low_pfn))
+		preferred = (goal - bdata->node_boot_start) >> PAGE_SHIFT;
+
+	areasize = (size+PAGE_SIZE-1)/PAGE_SIZE;	// 需要的整页数
+
+	/*
+	 * Fast path: small objects are packed into the tail of the page
+	 * used by the previous allocation without looking at the bitmap.
+	 */
+	if (align <= PAGE_SIZE && bdata->last_offset && 
+			bdata->last_pos >= preferred) {
+		unsigned long tail = (bdata->last_offset + align - 1) & ~(align - 1);
+
+		if (tail + size <= PAGE_SIZE) {
+			ret = phys_to_virt(bdata->node_boot_start +
+					   bdata->last_pos*PAGE_SIZE + tail);
+			bdata->last_offset = (tail + size) & ~PAGE_MASK;
+			memset(ret, 0, size);
+			return ret;
+		}
+	}
+
+	/*
+	 * Next-fit: start right behind the previous allocation if that
+	 * is above the goal, the area in between is most likely taken.
+	 */
+	start = preferred;
+	if (bdata->last_pos + 1 > preferred)
+		start = bdata->last_pos + 1;
+	limit = eidx;
+
+restart_scan:
+	// 整字跳过已分配的页，找 [start, limit) 中第一段对齐的空闲区
+	i = bitmap_find_next_zero_area_off(bdata->node_bootmem_map, limit,
+			start, areasize, align_mask, align_offset);
+	if (i + areasize <= limit) {
+		start = i;
+		goto found;
+	}
+
+	/*
+	 * Wrap around: everything from the goal up to where this pass
+	 * started, and finally the whole node below the goal.
+	 */
+	if (start > preferred) {
+		limit = start + areasize - 1 < eidx ? start + areasize - 1 : eidx;
+		start = preferred;
+		goto restart_scan;
+	}
+	if (preferred > 0) {
+		limit = preferred + areasize - 1 < eidx ? preferred + areasize - 1 : eidx;
+		start = preferred = 0;
+		goto restart_scan;
+	}
+	return NULL;
+found:
+	if (start >= eidx)
+		BUG();
+
+	/*
+	 * Is the next page of the previous allocation-end the start
+	 * of this allocation's buffer? If yes then we can 'merge'
+	 * the previous partial page with this allocation.
+	 */
+	if (align <= PAGE_SIZE
+	    && bdata->last_offset && bdata->last_pos+1 == start) {
+		unsigned long tail = (bdata->last_offset+align-1) & ~(align-1);
+
+		if (tail > PAGE_SIZE)
 			BUG();
+		remaining_size = PAGE_SIZE-tail;
+		if (size < remaining_size) {
+			areasize = 0;
+			// last_pos unchanged
+			bdata->last_offset = tail+size;
+			ret = phys_to_virt(bdata->last_pos*PAGE_SIZE + tail +
+						bdata->node_boot_start);
+		} else {
+			remaining_size = size - remaining_size;
+			areasize = (remaining_size+PAGE_SIZE-1)/PAGE_SIZE;
+			ret = phys_to_virt(bdata->last_pos*PAGE_SIZE + tail +
+						bdata->node_boot_start);
+			bdata->last_pos = start+areasize-1;
+			bdata->last_offset = remaining_size;
+		}
+		bdata->last_offset &= ~PAGE_MASK;
+	} else {
+		bdata->last_pos = start + areasize - 1;
+		bdata->last_offset = size & ~PAGE_MASK;
+		ret = phys_to_virt(start * PAGE_SIZE + bdata->node_boot_start);
+	}
+	/*
+	 * Reserve the area now:
+	 */
+	bitmap_set(bdata->node_bootmem_map, start, areasize);
+	memset(ret, 0, size);
+	return ret;
+}
+
+/*
+ * Give every page that is still free in the bitmap to the buddy
+ * allocator. The map is walked a word at a time for runs of free
+ * pages, each run goes to the free lists in max-order blocks.
+ */
+static unsigned long __init free_all_bootmem_core(pg_data_t *pgdat)
+{
+	bootmem_data_t *bdata = pgdat->bdata;
+	unsigned long start_pfn = bdata->node_boot_start >> PAGE_SHIFT;
+	unsigned long idx = bdata->node_low_pfn - start_pfn;
+	unsigned long *map = bdata->node_bootmem_map;
+	unsigned long s, e, map_pfn, count = 0;
+
+	if (!map) BUG();
+
+	/*
+	 * The allocator bitmap itself is not needed anymore once this
+	 * walk is done. Mark it free first, so that its pages end up in
+	 * the same runs as their free neighbours. Nothing below writes
+	 * to the pages being freed.
+	 */
+	map_pfn = __pa(map) >> PAGE_SHIFT;
+	bitmap_clear(map, map_pfn - start_pfn,
+		     ((idx + 7) / 8 + PAGE_SIZE - 1) >> PAGE_SHIFT);
+
+	// s 是空闲段的开始，e 是下一个已保留的页
+	for (s = find_next_zero_bit(map, idx, 0); s < idx;
+	     s = find_next_zero_bit(map, idx, e)) {
+		e = find_next_bit(map, idx, s);
+		if (e > idx)
+			e = idx;
+		count += free_pages_bootmem(start_pfn + s, start_pfn + e);
 	}
+	bdata->node_bootmem_map = NULL;
+
+	return count;
 }
 
 // 初始化引导内存管理器（bootmem），用于跟踪和管理系统的物理内存
@@ -158,4 +347,58 @@ void __init reserve_bootmem (unsigned long addr, unsigned long size)
 void __init free_bootmem (unsigned long addr, unsigned long size)
 {
 	return(free_bootmem_core(contig_page_data.bdata, addr, size));
-}
\ No newline at end of file
+}
+
+unsigned long __init free_all_bootmem (void)
+{
+	unsigned long long t0 = 0, t1 = 0;
+	unsigned long count;
+
+	if (cpu_has_tsc)
+		rdtscll(t0);
+	count = free_all_bootmem_core(&contig_page_data);
+	if (cpu_has_tsc)
+		rdtscll(t1);
+
+	printk("free_all_bootmem: %lu pages released in %Lu cycles\n",
+	       count, t1 - t0);
+	return count;
+}
+
+void * __init __alloc_bootmem (unsigned long size, unsigned long align, unsigned long goal)
+{
+	pg_data_t *pgdat = pgdat_list;
+	void *ptr;
+
+	// 依次尝试每一个节点
+	while (pgdat) {
+		if ((ptr = __alloc_bootmem_core(pgdat->bdata, size,
+						align, goal)))
+			return(ptr);
+		pgdat = pgdat->node_next;
+	}
+	/*
+	 * Whoops, we cannot satisfy the allocation request.
+	 */
+	printk(KERN_ALERT "bootmem alloc of %lu bytes failed!\n", size);
+	PANIC();
+	return NULL;
+}
+
+void * __init __alloc_bootmem_node (pg_data_t *pgdat, unsigned long size, unsigned long align, unsigned long goal)
+{
+	void *ptr;
+
+	ptr = __alloc_bootmem_core(pgdat->bdata, size, align, goal);
+	if (ptr)
+		return (ptr);
+
+	/*
+	 * Whoops, we cannot satisfy the allocation request.
+	 */
+	printk(KERN_ALERT "bootmem alloc of %lu bytes failed!\n", size);
+	PANIC();
+	return NULL;
+}
+
+#endif /* !CONFIG_NO_BOOTMEM */
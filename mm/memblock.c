@@ -0,0 +1,424 @@
+/*
+ *  linux/mm/memblock.c
+ *
+ *  Procedures for maintaining information about logical memory blocks.
+ *
+ *  The boot-time allocator used to be a bitmap with one bit per page
+ *  of the node, holes included, and every reserve/free walked that
+ *  bitmap page by page with a locked bit operation. Here memory is
+ *  described by two sorted arrays of [base, base+size) ranges built
+ *  straight from the e820 map, so every operation is O(regions).
+ */
+
+#include <linux/memblock.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/debug.h>
+#include <asm/page.h>
+#include <asm/io.h>
+#include <asm/stdio.h>
+
+static struct memblock_region memblock_memory_init_regions[INIT_MEMBLOCK_REGIONS] __initdata;
+static struct memblock_region memblock_reserved_init_regions[INIT_MEMBLOCK_REGIONS] __initdata;
+
+struct memblock memblock __initdata = {
+	current_limit:	~(phys_addr_t)0,
+	memory: {
+		cnt:		0,
+		max:		INIT_MEMBLOCK_REGIONS,
+		regions:	memblock_memory_init_regions,
+	},
+	reserved: {
+		cnt:		0,
+		max:		INIT_MEMBLOCK_REGIONS,
+		regions:	memblock_reserved_init_regions,
+	},
+};
+
+/* adjust *@size so that (@base + *@size) doesn't overflow, return new size */
+static inline phys_addr_t memblock_cap_size(phys_addr_t base, phys_addr_t *size)
+{
+	if (*size > ~(phys_addr_t)0 - base)
+		*size = ~(phys_addr_t)0 - base;
+	return *size;
+}
+
+/*
+ * Move regions [@from, cnt) of @type so that they start at @to.
+ * Regions overlap when moving up by one, so copy from the top.
+ */
+static void __init memblock_move_regions(struct memblock_type *type,
+					 unsigned long to, unsigned long from)
+{
+	unsigned long i, n = type->cnt - from;
+
+	if (to < from) {
+		for (i = 0; i < n; i++)
+			type->regions[to + i] = type->regions[from + i];
+	} else if (to > from) {
+		for (i = n; i > 0; i--)
+			type->regions[to + i - 1] = type->regions[from + i - 1];
+	}
+}
+
+/**
+ * memblock_double_array - double the size of the memblock regions array
+ * @type: memblock type of the regions array being doubled
+ * @new_area_start: starting address of memory range to avoid overlap with
+ * @new_area_size: size of memory range to avoid overlap with
+ *
+ * The new array is carved out of memblock itself, so it is always
+ * inside the direct mapped memory. It must not overlap the range that
+ * is being added right now: that range was usually just found free by
+ * memblock_find_in_range() and isn't reserved yet. The static arrays
+ * are __initdata and are simply abandoned, a previously doubled array
+ * is given back.
+ */
+static int __init memblock_double_array(struct memblock_type *type,
+					phys_addr_t new_area_start,
+					phys_addr_t new_area_size)
+{
+	struct memblock_region *new_array, *old_array = type->regions;
+	phys_addr_t old_size, new_size, addr;
+	unsigned long i;
+
+	old_size = type->max * sizeof(struct memblock_region);
+	new_size = old_size << 1;
+
+	addr = memblock_find_in_range(new_area_start + new_area_size,
+				      MEMBLOCK_ALLOC_ACCESSIBLE,
+				      new_size, sizeof(phys_addr_t));
+	if (!addr && new_area_size)
+		addr = memblock_find_in_range(0, new_area_start,
+					      new_size, sizeof(phys_addr_t));
+	if (!addr) {
+		printk(KERN_ERR "memblock: failed to double %s array from %lu to %lu entries!\n",
+		       type == &memblock.memory ? "memory" : "reserved",
+		       type->max, type->max * 2);
+		return -1;
+	}
+
+	new_array = phys_to_virt(addr);
+	for (i = 0; i < type->cnt; i++)
+		new_array[i] = old_array[i];
+	type->regions = new_array;
+	type->max <<= 1;
+
+	/* there is room for the new entry now */
+	memblock_reserve(addr, new_size);
+	if (old_array != memblock_memory_init_regions &&
+	    old_array != memblock_reserved_init_regions)
+		memblock_free(__pa(old_array), old_size);
+	return 0;
+}
+
+/**
+ * memblock_add_region - add new memblock region
+ * @type: memblock type to add new region into
+ * @base: base address of the new region
+ * @size: size of the new region
+ *
+ * Add new memblock region [@base,@base+@size) into @type. Regions that
+ * overlap or touch the new one are merged with it, so @type stays
+ * sorted and free of overlaps.
+ */
+static int __init memblock_add_region(struct memblock_type *type,
+				      phys_addr_t base, phys_addr_t size)
+{
+	unsigned long first, last, nr;
+	phys_addr_t end;
+
+	if (!size)
+		return 0;
+	end = base + memblock_cap_size(base, &size);
+
+	// 第一个与新区间重叠或相邻的区间
+	for (first = 0; first < type->cnt; first++)
+		if (type->regions[first].base + type->regions[first].size >= base)
+			break;
+	// 第一个完全位于新区间之后的区间
+	for (last = first; last < type->cnt; last++)
+		if (type->regions[last].base > end)
+			break;
+
+	nr = last - first;	// [first, last) 都要和新区间合并成一个
+	if (nr) {
+		struct memblock_region *tail = &type->regions[last - 1];
+
+		if (type->regions[first].base < base)
+			base = type->regions[first].base;
+		if (tail->base + tail->size > end)
+			end = tail->base + tail->size;
+	} else if (type->cnt >= type->max) {
+		/* the array is full, grow it and start over */
+		if (memblock_double_array(type, base, end - base) < 0)
+			return -1;
+		return memblock_add_region(type, base, end - base);
+	}
+
+	memblock_move_regions(type, first + 1, last);
+	type->regions[first].base = base;
+	type->regions[first].size = end - base;
+	type->cnt = type->cnt - nr + 1;
+	return 0;
+}
+
+/**
+ * memblock_remove_range - remove a range from a memblock type
+ * @type: memblock type to remove the range from
+ * @base: base address of the range
+ * @size: size of the range
+ *
+ * Regions that are partially covered are trimmed, a region that fully
+ * contains the range is split in two.
+ */
+static int __init memblock_remove_range(struct memblock_type *type,
+					phys_addr_t base, phys_addr_t size)
+{
+	unsigned long i, first = type->cnt, last = type->cnt;
+	phys_addr_t end;
+
+	if (!size)
+		return 0;
+	end = base + memblock_cap_size(base, &size);
+
+	for (i = 0; i < type->cnt; i++) {
+		struct memblock_region *rgn = &type->regions[i];
+		phys_addr_t rbase = rgn->base;
+		phys_addr_t rend = rbase + rgn->size;
+
+		if (rend <= base)
+			continue;
+		if (rbase >= end)
+			break;
+
+		if (rbase < base) {
+			if (rend > end) {
+				/* @rgn contains the whole range: split it */
+				if (type->cnt >= type->max) {
+					if (memblock_double_array(type, base, size) < 0)
+						return -1;
+					return memblock_remove_range(type, base, size);
+				}
+				memblock_move_regions(type, i + 2, i + 1);
+				type->cnt++;
+				rgn->size = base - rbase;
+				type->regions[i + 1].base = end;
+				type->regions[i + 1].size = rend - end;
+				return 0;
+			}
+			rgn->size = base - rbase;	// 去掉尾部
+			continue;
+		}
+		if (rend > end) {
+			rgn->base = end;		// 去掉头部
+			rgn->size = rend - end;
+			break;
+		}
+		/* fully covered, the covered regions are contiguous */
+		if (first == type->cnt)
+			first = i;
+		last = i + 1;
+	}
+
+	if (first != type->cnt) {
+		memblock_move_regions(type, first, last);
+		type->cnt -= last - first;
+	}
+	return 0;
+}
+
+// 登记一段物理内存（一般来自 e820 的 E820_RAM 条目）
+int __init memblock_add(phys_addr_t base, phys_addr_t size)
+{
+	return memblock_add_region(&memblock.memory, base, size);
+}
+
+int __init memblock_remove(phys_addr_t base, phys_addr_t size)
+{
+	return memblock_remove_range(&memblock.memory, base, size);
+}
+
+// 标记一段物理内存为已占用
+int __init memblock_reserve(phys_addr_t base, phys_addr_t size)
+{
+	return memblock_add_region(&memblock.reserved, base, size);
+}
+
+// 归还一段之前保留/分配的物理内存
+int __init memblock_free(phys_addr_t base, phys_addr_t size)
+{
+	return memblock_remove_range(&memblock.reserved, base, size);
+}
+
+/**
+ * __next_free_mem_range - next function for for_each_free_mem_range()
+ * @idx: pointer to u64 loop variable
+ * @out_start: ptr to phys_addr_t for start address of the range, can be %NULL
+ * @out_end: ptr to phys_addr_t for end address of the range, can be %NULL
+ *
+ * Find the first free area from *@idx which matches. The low 32 bits
+ * of *@idx index the memory type, the high 32 bits index the gaps of
+ * the reserved type (gap i lies before reserved region i). Both arrays
+ * are sorted, so a full walk is O(memory + reserved).
+ */
+void __init __next_free_mem_range(unsigned long long *idx,
+				  phys_addr_t *out_start, phys_addr_t *out_end)
+{
+	struct memblock_type *mem = &memblock.memory;
+	struct memblock_type *rsv = &memblock.reserved;
+	unsigned long mi = (unsigned long)(*idx & 0xffffffff);
+	unsigned long ri = (unsigned long)(*idx >> 32);
+
+	for ( ; mi < mem->cnt; mi++) {
+		struct memblock_region *m = &mem->regions[mi];
+		phys_addr_t m_start = m->base;
+		phys_addr_t m_end = m->base + m->size;
+
+		/* scan areas before each reservation */
+		for ( ; ri < rsv->cnt + 1; ri++) {
+			struct memblock_region *r = &rsv->regions[ri];
+			phys_addr_t r_start = ri ? r[-1].base + r[-1].size : 0;
+			phys_addr_t r_end = ri < rsv->cnt ? r->base : ~(phys_addr_t)0;
+
+			/* if ri advanced past mi, break out to advance mi */
+			if (r_start >= m_end)
+				break;
+			/* if the two regions intersect, we're done */
+			if (m_start < r_end) {
+				if (out_start)
+					*out_start = m_start > r_start ? m_start : r_start;
+				if (out_end)
+					*out_end = m_end < r_end ? m_end : r_end;
+				/*
+				 * The region which ends first is advanced
+				 * for the next iteration.
+				 */
+				if (m_end <= r_end)
+					mi++;
+				else
+					ri++;
+				*idx = (unsigned long long)mi | ((unsigned long long)ri << 32);
+				return;
+			}
+		}
+	}
+
+	/* signal end of iteration */
+	*idx = (unsigned long long)-1;
+}
+
+/**
+ * memblock_find_in_range - find free area in given range
+ * @start: start of candidate range
+ * @end: end of candidate range, can be %MEMBLOCK_ALLOC_ACCESSIBLE
+ * @size: size of free area to find
+ * @align: alignment of free area to find
+ *
+ * Bottom-up first fit, so low (DMA capable) memory is only used when
+ * the caller asks for it or nothing else is left.
+ *
+ * RETURNS:
+ * Found address on success, 0 on failure.
+ */
+phys_addr_t __init memblock_find_in_range(phys_addr_t start, phys_addr_t end,
+					  phys_addr_t size, phys_addr_t align)
+{
+	phys_addr_t this_start, this_end, cand;
+	unsigned long long i;
+
+	if (end == MEMBLOCK_ALLOC_ACCESSIBLE || end > memblock.current_limit)
+		end = memblock.current_limit;
+	if (!align)
+		align = 1;
+	/* avoid allocating the first page, 0 means failure */
+	if (start < PAGE_SIZE)
+		start = PAGE_SIZE;
+
+	for_each_free_mem_range(i, &this_start, &this_end) {
+		if (this_end <= start)
+			continue;
+		if (this_start >= end)
+			break;
+		if (this_start < start)
+			this_start = start;
+		if (this_end > end)
+			this_end = end;
+
+		cand = (this_start + align - 1) & ~(align - 1);
+		if (cand >= this_start && cand < this_end && this_end - cand >= size)
+			return cand;
+	}
+	return 0;
+}
+
+// 在 [start, end) 中找到一块空闲内存并立即保留，失败返回 0
+phys_addr_t __init memblock_alloc_range(phys_addr_t size, phys_addr_t align,
+					phys_addr_t start, phys_addr_t end)
+{
+	phys_addr_t found;
+
+	found = memblock_find_in_range(start, end, size, align);
+	if (found && !memblock_reserve(found, size))
+		return found;
+	return 0;
+}
+
+// 可用物理内存总量
+phys_addr_t __init memblock_phys_mem_size(void)
+{
+	phys_addr_t total = 0;
+	unsigned long i;
+
+	for (i = 0; i < memblock.memory.cnt; i++)
+		total += memblock.memory.regions[i].size;
+	return total;
+}
+
+void __init memblock_set_current_limit(phys_addr_t limit)
+{
+	memblock.current_limit = limit;
+}
+
+// 二分查找 reserved 数组，判断 addr 是否已被占用
+int __init memblock_is_reserved(phys_addr_t addr)
+{
+	unsigned long left = 0, right = memblock.reserved.cnt;
+
+	while (left < right) {
+		unsigned long mid = (left + right) / 2;
+		struct memblock_region *r = &memblock.reserved.regions[mid];
+
+		if (addr < r->base)
+			right = mid;
+		else if (addr >= r->base + r->size)
+			left = mid + 1;
+		else
+			return 1;
+	}
+	return 0;
+}
+
+static void __init memblock_dump(struct memblock_type *type, char *name)
+{
+	unsigned long i;
+
+	printk(" %s.cnt  = 0x%lx\n", name, type->cnt);
+	for (i = 0; i < type->cnt; i++) {
+		struct memblock_region *rgn = &type->regions[i];
+
+		printk(" %s[0x%lx]\t[%016Lx-%016Lx], 0x%Lx bytes\n", name, i,
+		       (unsigned long long)rgn->base,
+		       (unsigned long long)(rgn->base + rgn->size - 1),
+		       (unsigned long long)rgn->size);
+	}
+}
+
+void __init memblock_dump_all(void)
+{
+	printk("MEMBLOCK configuration:\n");
+	printk(" memory size = 0x%Lx\n", (unsigned long long)memblock_phys_mem_size());
+
+	memblock_dump(&memblock.memory, "memory");
+	memblock_dump(&memblock.reserved, "reserved");
+}
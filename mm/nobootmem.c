@@ -0,0 +1,139 @@
+/*
+ *  linux/mm/nobootmem.c
+ *
+ *  The bootmem API (init_bootmem, reserve_bootmem, free_bootmem,
+ *  __alloc_bootmem...) implemented on top of memblock instead of the
+ *  per-page bitmap in mm/bootmem.c. Selected with CONFIG_NO_BOOTMEM.
+ */
+
+#include <linux/bootmem.h>
+#include <linux/memblock.h>
+#include <linux/init.h>
+#include <linux/mmzone.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include <linux/mm.h>
+#include <linux/debug.h>
+#include <asm/io.h>
+#include <asm/stdio.h>
+#include <asm/processor.h>
+#include <asm/msr.h>
+
+#ifdef CONFIG_NO_BOOTMEM
+
+/*
+ * No bitmap to set up: remember the low memory limit, hook the node
+ * into pgdat_list and restrict memblock allocations to the directly
+ * mapped memory. Returns the size of the (non-existent) bootmap.
+ */
+unsigned long __init init_bootmem (unsigned long start, unsigned long pages)
+{
+	pg_data_t *pgdat = &contig_page_data;
+	bootmem_data_t *bdata = pgdat->bdata;
+
+	max_low_pfn = pages;
+	min_low_pfn = start;
+
+	pgdat->node_next = pgdat_list;
+	pgdat_list = pgdat;
+	bdata->node_boot_start = 0;
+	bdata->node_low_pfn = pages;
+	bdata->node_bootmem_map = NULL;
+
+	memblock_set_current_limit((phys_addr_t)pages << PAGE_SHIFT);
+	return 0;
+}
+
+void __init reserve_bootmem (unsigned long addr, unsigned long size)
+{
+	if (!size) BUG();
+	memblock_reserve(addr, size);
+}
+
+void __init free_bootmem (unsigned long addr, unsigned long size)
+{
+	if (!size) BUG();
+	memblock_free(addr, size);
+}
+
+/*
+ * Give all free memblock ranges below max_low_pfn to the buddy
+ * allocator, each range in max-order blocks. memblock's own arrays
+ * stay reserved.
+ */
+unsigned long __init free_all_bootmem (void)
+{
+	unsigned long long i, t0 = 0, t1 = 0;
+	phys_addr_t start, end;
+	unsigned long start_pfn, end_pfn, count = 0;
+
+	if (cpu_has_tsc)
+		rdtscll(t0);
+	for_each_free_mem_range(i, &start, &end) {
+		// 只释放完整的页
+		start_pfn = (start + PAGE_SIZE - 1) >> PAGE_SHIFT;
+		end_pfn = end >> PAGE_SHIFT;
+		if (end_pfn > max_low_pfn)
+			end_pfn = max_low_pfn;
+		if (start_pfn < end_pfn)
+			count += free_pages_bootmem(start_pfn, end_pfn);
+	}
+	if (cpu_has_tsc)
+		rdtscll(t1);
+
+	printk("free_all_bootmem: %lu pages released in %Lu cycles\n",
+	       count, t1 - t0);
+	return count;
+}
+
+static void * __init ___alloc_bootmem_nopanic(unsigned long size,
+	unsigned long align, unsigned long goal, unsigned long limit)
+{
+	phys_addr_t addr = 0;
+	void *ptr;
+
+	if (!size) BUG();
+	if (align & (align-1))
+		BUG();
+
+	/*
+	 * Try above 'goal' first, then fall back to lower memory.
+	 */
+	if (goal)
+		addr = memblock_alloc_range(size, align, goal, limit);
+	if (!addr)
+		addr = memblock_alloc_range(size, align, 0, limit);
+	if (!addr)
+		return NULL;
+
+	ptr = phys_to_virt(addr);
+	memset(ptr, 0, size);
+	return ptr;
+}
+
+void * __init __alloc_bootmem (unsigned long size, unsigned long align, unsigned long goal)
+{
+	void *ptr;
+
+	ptr = ___alloc_bootmem_nopanic(size, align, goal, MEMBLOCK_ALLOC_ACCESSIBLE);
+	if (ptr)
+		return ptr;
+
+	/*
+	 * Whoops, we cannot satisfy the allocation request.
+	 */
+	printk(KERN_ALERT "bootmem alloc of %lu bytes failed!\n", size);
+	PANIC();
+	return NULL;
+}
+
+/*
+ * memblock doesn't track nodes, every node lives in the same arrays
+ * on this UMA kernel.
+ */
+void * __init __alloc_bootmem_node (pg_data_t *pgdat, unsigned long size, unsigned long align, unsigned long goal)
+{
+	return __alloc_bootmem(size, align, goal);
+}
+
+#endif /* CONFIG_NO_BOOTMEM */
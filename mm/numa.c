@@ -1,5 +1,6 @@
 #include <linux/bootmem.h>
 #include <linux/mmzone.h>
+#include <linux/mm.h>
 
 // 初始化一个整型变量numnodes为1，用于表示节点数量。在UMA（Uniform Memory Access）平台上进行初始化。
 int numnodes = 1;	/* Initialized for UMA platforms */
@@ -9,4 +10,16 @@ static bootmem_data_t contig_bootmem_data;
 // 定义一个pg_data_t类型的变量contig_page_data，并使用初始化器初始化。
 // 初始化中包含一个字段bdata，指向先前定义的contig_bootmem_data变量。
 // 该变量用于描述连续物理内存分配的引导数据。
-pg_data_t contig_page_data = { bdata: &contig_bootmem_data };
\ No newline at end of file
+pg_data_t contig_page_data = { bdata: &contig_bootmem_data };
+/*
+ * Set up the zones and mem_map of a node whose page frames are not all
+ * backed by RAM; @zholes_size gives the number of missing pages in each
+ * zone. On UMA there is only contig_page_data, and its map is mem_map.
+ */
+void __init free_area_init_node(int nid, pg_data_t *pgdat, struct page *pmap,
+	unsigned long *zones_size, unsigned long zone_start_paddr, 
+	unsigned long *zholes_size)
+{
+	free_area_init_core(0, &contig_page_data, &mem_map, zones_size, 
+				zone_start_paddr, zholes_size, pmap);
+}
@@ -1,3 +1,1020 @@
+/*
+ *  linux/mm/page_alloc.c
+ *
+ *  Manages the free list, the system allocates free pages here.
+ *  Note that kmalloc() lives in slab.c
+ *
+ *  Copyright (C) 1991, 1992, 1993, 1994  Linus Torvalds
+ *  Swap reorganised 29.12.95, Stephen Tweedie
+ *  Support of BIGMEM added by Gerhard Wichert, Siemens AG, July 1999
+ *  Reshaped it to be a zoned allocator, Ingo Molnar, Red Hat, 1999
+ *  Discontiguous memory support, Kanoj Sarcar, SGI, Nov 1999
+ *  Zone balancing, Kanoj Sarcar, SGI, Jan 2000
+ */
+
+#include <linux/mm.h>
 #include <linux/mmzone.h>
+#include <linux/slab.h>
+#include <linux/bootmem.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/debug.h>
+#include <linux/string.h>
+#include <linux/spinlock.h>
+#include <linux/smp.h>
+#include <linux/highmem.h>
+#include <asm/stdio.h>
+
+pg_data_t *pgdat_list;
+
+mem_map_t * mem_map;
+unsigned long max_mapnr;
+unsigned long num_physpages;
+void * high_memory;
+unsigned long totalram_pages;
+
+/*
+ * Used by page_zone() to look up the zone of a page from the zone
+ * and node number kept in page->flags.
+ */
+zone_t *zone_table[1 << ZONETABLE_SHIFT];
+
+seqcount_t zonelist_seq = SEQCNT_ZERO;
+
+static char *zone_names[MAX_NR_ZONES] = { "DMA", "Normal", "HighMem" };
+static int zone_balance_ratio[MAX_NR_ZONES] __initdata = { 128, 128, 128, };
+static int zone_balance_min[MAX_NR_ZONES] __initdata = { 20 , 20, 20, };
+static int zone_balance_max[MAX_NR_ZONES] __initdata = { 255 , 255, 255, };
+
+/*
+ * Temporary debugging check.
+ */
+#define BAD_RANGE(zone, page)						\
+(									\
+	(page_to_pfn(page) >= ((zone)->zone_start_mapnr+(zone)->size))	\
+	|| (page_to_pfn(page) < (zone)->zone_start_mapnr)		\
+	|| ((zone) != page_zone(page))					\
+)
+
+/*
+ * Freeing function for a buddy system allocator.
+ * Contrary to prior comments, this is *NOT* hairy, and there
+ * is no reason for anyone not to understand it.
+ *
+ * The concept of a buddy system is to maintain direct-mapped tables
+ * (containing bit values) for memory blocks of various "orders".
+ * The bottom level table contains the map for the smallest allocatable
+ * units of memory (here, pages), and each level above it describes
+ * pairs of units from the levels below, hence, "buddies".
+ * At a high level, all that happens here is marking the table entry
+ * at the bottom level available, and propagating the changes upward
+ * as necessary, plus some accounting needed to play nicely with other
+ * parts of the VM system.
+ * At each level, we keep one bit for each pair of blocks, which
+ * is set to 1 iff only one of the pair is allocated.  So when we
+ * are allocating or freeing one, we can derive the state of the
+ * other.  That is, if we allocate a small block, and both were   
+ * free, the remainder of the region must be split into blocks.   
+ * If a block is freed, and its buddy is also free, then this
+ * triggers coalescing into a block of larger size.            
+ *
+ * Every step is a constant amount of work per order: a bit flip and
+ * a list_del() of the buddy, the free lists are never searched.
+ *
+ * -- wli
+ */
+
+static inline void __free_one_page (struct page *page, zone_t *zone,
+	unsigned int order)
+{
+	unsigned long index, page_idx, mask;
+	free_area_t *area;
+
+	mask = (~0UL) << order;
+	page_idx = page_to_pfn(page) - zone->zone_start_mapnr;
+	if (page_idx & ~mask)
+		BUG();
+	index = page_idx >> (1 + order);
+
+	area = zone->free_area + order;
+
+	zone->free_pages -= mask;
+
+	while (mask + (1 << (MAX_ORDER-1))) {
+		struct page *buddy1, *buddy2;
+
+		if (area >= zone->free_area + MAX_ORDER)
+			BUG();
+		if (!__test_and_change_bit(index, area->map))
+			/*
+			 * the buddy page is still allocated.
+			 */
+			break;
+		/*
+		 * Move the buddy up one level.
+		 * This code is taking advantage of the identity:
+		 * 	-mask = 1+~mask
+		 * A MAX_ORDER block never spans two pieces of mem_map
+		 * (see CONFIG_SPARSEMEM), so the buddy is reached from
+		 * @page directly.
+		 */
+		buddy1 = page + ((page_idx ^ -mask) - page_idx);
+		buddy2 = page;
+		if (BAD_RANGE(zone,buddy1))
+			BUG();
+		if (BAD_RANGE(zone,buddy2))
+			BUG();
+
+		list_del(&buddy1->list);
+		mask <<= 1;
+		area++;
+		index >>= 1;
+		page += (page_idx & mask) - page_idx;
+		page_idx &= mask;
+	}
+	page->private = area - zone->free_area;	// 空闲块的阶
+	list_add(&page->list, &area->free_list);
+}
+
+static inline void free_pages_check(struct page *page)
+{
+	if (PageLocked(page))
+		BUG();
+	if (PageActive(page))
+		BUG();
+	if (PageSlab(page))
+		BUG();
+	page->flags &= ~((1<<PG_referenced) | (1<<PG_dirty));
+}
+
+/*
+ * Frees a list of pages. 
+ * Assumes all pages on list are in same zone, and of same order.
+ * count is the maximum number of pages to free.
+ */
+static int free_pages_bulk(zone_t *zone, int count,
+		struct list_head *list, unsigned int order)
+{
+	unsigned long flags;
+	struct page *page;
+	int ret = 0;
+
+	spin_lock_irqsave(&zone->lock, flags);
+	while (!list_empty(list) && count--) {
+		// 从链表尾部取，最冷的页先还给伙伴系统
+		page = list_entry(list->prev, struct page, list);
+		/* have to delete it as __free_one_page list manipulates */
+		list_del(&page->list);
+		__free_one_page(page, zone, order);
+		ret++;
+	}
+	spin_unlock_irqrestore(&zone->lock, flags);
+	return ret;
+}
+
+static void __free_pages_ok (struct page *page, unsigned int order)
+{
+	unsigned long flags;
+	zone_t *zone = page_zone(page);
+
+	free_pages_check(page);
+	spin_lock_irqsave(&zone->lock, flags);
+	__free_one_page(page, zone, order);
+	spin_unlock_irqrestore(&zone->lock, flags);
+}
+
+#define MARK_USED(index, order, area) \
+	__change_bit((index) >> (1+(order)), (area)->map)
+
+/*
+ * Split a block of order @high down to order @low. The lower half
+ * goes back on the free list at every step, the last (highest)
+ * @low block is returned.
+ */
+static inline struct page * expand (zone_t *zone, struct page *page,
+	 unsigned long index, int low, int high, free_area_t * area)
+{
+	unsigned long size = 1 << high;
+
+	while (high > low) {
+		if (BAD_RANGE(zone,page))
+			BUG();
+		area--;
+		high--;
+		size >>= 1;
+		// 前一半挂到低一阶的空闲链表上，后一半继续拆分
+		page->private = high;
+		list_add(&(page)->list, &(area)->free_list);
+		MARK_USED(index, high, area);
+		index += size;
+		page += size;
+	}
+	if (BAD_RANGE(zone,page))
+		BUG();
+	return page;
+}
+
+/* 
+ * Do the hard work of removing an element from the buddy allocator.
+ * Call me with the zone->lock already held.
+ */
+static struct page *__rmqueue(zone_t *zone, unsigned int order)
+{
+	free_area_t * area = zone->free_area + order;
+	unsigned int curr_order = order;
+	struct list_head *head, *curr;
+	struct page *page;
+
+	do {
+		head = &area->free_list;
+		curr = head->next;
+
+		if (curr != head) {
+			unsigned int index;
+
+			page = list_entry(curr, struct page, list);
+			if (BAD_RANGE(zone,page))
+				BUG();
+			list_del(curr);
+			index = page_to_pfn(page) - zone->zone_start_mapnr;
+			if (curr_order != MAX_ORDER-1)
+				MARK_USED(index, curr_order, area);
+			zone->free_pages -= 1UL << order;
+
+			return expand(zone, page, index, order, curr_order, area);
+		}
+		curr_order++;
+		area++;
+	} while (curr_order < MAX_ORDER);
+
+	return NULL;
+}
+
+/* 
+ * Obtain a specified number of elements from the buddy allocator, all under
+ * a single hold of the lock, for efficiency.  Add them to the supplied list.
+ * Returns the number of new pages which were placed at *list.
+ */
+static int rmqueue_bulk(zone_t *zone, unsigned int order, 
+			unsigned long count, struct list_head *list)
+{
+	unsigned long flags;
+	int i;
+	int allocated = 0;
+	struct page *page;
+	
+	spin_lock_irqsave(&zone->lock, flags);
+	for (i = 0; i < count; ++i) {
+		page = __rmqueue(zone, order);
+		if (page == NULL)
+			break;
+		allocated++;
+		list_add_tail(&page->list, list);
+	}
+	spin_unlock_irqrestore(&zone->lock, flags);
+	return allocated;
+}
+
+/*
+ * Spill all of this CPU's per-cpu pages back into the buddy allocator.
+ */
+void drain_local_pages(void)
+{
+	unsigned long flags;
+	pg_data_t *pgdat;
+	int i;
+
+	local_irq_save(flags);	
+	for (pgdat = pgdat_list; pgdat; pgdat = pgdat->node_next) {
+		zone_t *zone;
+
+		for (zone = pgdat->node_zones; zone < pgdat->node_zones + MAX_NR_ZONES; zone++) {
+			struct per_cpu_pageset *pset;
+
+			pset = &zone->pageset[smp_processor_id()];
+			for (i = 0; i < ARRAY_SIZE(pset->pcp); i++) {
+				struct per_cpu_pages *pcp;
+
+				pcp = &pset->pcp[i];
+				pcp->count -= free_pages_bulk(zone, pcp->count,
+						&pcp->list, 0);
+			}
+		}
+	}
+	local_irq_restore(flags);	
+}
+
+/*
+ * Free a 0-order page
+ *
+ * Hot pages go to the head of the hot list and are handed out again
+ * first, their cache lines are most likely still warm. Cold pages go
+ * to their own list. When a list grows past ->high, ->batch pages
+ * from its cold end go back to the buddy lists in one zone->lock hold.
+ */
+static void free_hot_cold_page(struct page *page, int cold)
+{
+	zone_t *zone = page_zone(page);
+	struct per_cpu_pages *pcp;
+	unsigned long flags;
+
+	free_pages_check(page);
+	local_irq_save(flags);
+	pcp = &zone->pageset[smp_processor_id()].pcp[cold];
+	if (pcp->count >= pcp->high)
+		pcp->count -= free_pages_bulk(zone, pcp->batch, &pcp->list, 0);
+	list_add(&page->list, &pcp->list);
+	pcp->count++;
+	local_irq_restore(flags);
+}
+
+void free_hot_page(struct page *page)
+{
+	free_hot_cold_page(page, 0);
+}
+	
+void free_cold_page(struct page *page)
+{
+	free_hot_cold_page(page, 1);
+}
+
+/*
+ * Take one page off the pool the idle loop has cleared.
+ */
+static struct page *rmqueue_zeroed(zone_t *zone)
+{
+	unsigned long flags;
+	struct page *page = NULL;
+
+	if (!zone->nr_zero_pages)
+		return NULL;
+	spin_lock_irqsave(&zone->lock, flags);
+	if (!list_empty(&zone->zero_list)) {
+		page = list_entry(zone->zero_list.next, struct page, list);
+		list_del(&page->list);
+		zone->nr_zero_pages--;
+		zone->free_pages--;
+	}
+	spin_unlock_irqrestore(&zone->lock, flags);
+	return page;
+}
+
+static inline void prep_zero_page(struct page *page, int order)
+{
+	int i;
+
+	for (i = 0; i < (1 << order); i++)
+		clear_highpage(page + i);
+}
+
+/*
+ * Order-0 requests are served from this CPU's hot or cold list without
+ * zone->lock, which is only taken to refill the list ->batch pages at
+ * a time once it drops to ->low.
+ *
+ * __GFP_ZERO order-0 requests try the pre-zeroed pool first, any other
+ * order-0 request only touches it once the buddy lists are empty, so
+ * the idle loop's work isn't wasted on callers that overwrite the page
+ * anyway.
+ */
+static struct page *buffered_rmqueue(zone_t *zone, int order, int gfp_mask)
+{
+	unsigned long flags;
+	struct page *page = NULL;
+	int cold = !!(gfp_mask & __GFP_COLD);
+	int zeroed = 0;
+
+	if (order == 0 && (gfp_mask & __GFP_ZERO)) {
+		page = rmqueue_zeroed(zone);
+		if (page)
+			zeroed = 1;
+	}
+
+	if (page == NULL && order == 0) {
+		struct per_cpu_pages *pcp;
+
+		local_irq_save(flags);
+		pcp = &zone->pageset[smp_processor_id()].pcp[cold];
+		if (pcp->count <= pcp->low)
+			pcp->count += rmqueue_bulk(zone, 0,
+						pcp->batch, &pcp->list);
+		if (pcp->count) {
+			page = list_entry(pcp->list.next, struct page, list);
+			list_del(&page->list);
+			pcp->count--;
+		}
+		local_irq_restore(flags);
+	}
+
+	if (page == NULL) {
+		spin_lock_irqsave(&zone->lock, flags);
+		page = __rmqueue(zone, order);
+		spin_unlock_irqrestore(&zone->lock, flags);
+	}
+
+	// 伙伴系统里已经没有页面了，最后才动用预先清零的页面
+	if (page == NULL && order == 0 && !zeroed)
+		page = rmqueue_zeroed(zone);
+
+	if (page != NULL) {
+		if (BAD_RANGE(zone,page))
+			BUG();
+		if (PageLocked(page))
+			BUG();
+		if (PageActive(page))
+			BUG();
+		set_page_count(page, 1);
+		if ((gfp_mask & __GFP_ZERO) && !zeroed)
+			prep_zero_page(page, order);
+	}
+	return page;
+}
+
+/*
+ * Called from the idle loop: move one free page of the highest zone
+ * that has memory to spare onto that zone's pre-zeroed pool. The page
+ * is cleared outside zone->lock. Zones at or below pages_high, and
+ * ZONE_DMA, are left alone. Returns 1 if a page was zeroed, 0 when
+ * every pool is full.
+ */
+int idle_zero_page(void)
+{
+	pg_data_t *pgdat;
+	unsigned long flags;
+
+	for (pgdat = pgdat_list; pgdat; pgdat = pgdat->node_next) {
+		zone_t *zone;
+
+		for (zone = pgdat->node_zones + MAX_NR_ZONES - 1; zone >= pgdat->node_zones; zone--) {
+			struct page *page;
+
+			if (zone->nr_zero_pages >= zone->zero_pages_high)
+				continue;
+			if (zone->free_pages <= zone->pages_high)
+				continue;
+
+			spin_lock_irqsave(&zone->lock, flags);
+			page = __rmqueue(zone, 0);
+			spin_unlock_irqrestore(&zone->lock, flags);
+			if (page == NULL)
+				continue;
+
+			clear_highpage(page);
+
+			spin_lock_irqsave(&zone->lock, flags);
+			list_add(&page->list, &zone->zero_list);
+			zone->nr_zero_pages++;
+			zone->free_pages++;
+			spin_unlock_irqrestore(&zone->lock, flags);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+struct page *_alloc_pages(unsigned int gfp_mask, unsigned int order)
+{
+	return __alloc_pages(gfp_mask, order,
+		contig_page_data.node_zonelists+(gfp_mask & GFP_ZONEMASK));
+}
+
+struct page * alloc_pages_node(int nid, unsigned int gfp_mask, unsigned int order)
+{
+	return _alloc_pages(gfp_mask, order);
+}
+
+/*
+ * This is the 'heart' of the zoned buddy allocator:
+ *
+ * The zonelist is walked in fallback order (HighMem -> Normal -> DMA)
+ * twice: first only zones that stay above pages_low after the
+ * allocation are used, then zones may be drained down to pages_min
+ * (a quarter of it for callers that cannot wait). Only __GFP_HIGH
+ * callers may take the last pages. The only reclaim is giving the
+ * empty slabs back (kmem_cache_reap()), done once for callers that
+ * may wait before they dip into the pages_min reserve.
+ */
+struct page * __alloc_pages(unsigned int gfp_mask, unsigned int order, zonelist_t *zonelist)
+{
+	unsigned long min;
+	zone_t **zone, * classzone;
+	struct page * page;
+	int reaped = 0;
+	unsigned seq;
+
+restart:
+	seq = read_seqcount_begin(&zonelist_seq);
+	zone = zonelist->zones;
+	classzone = *zone;
+	if (classzone == NULL)
+		goto nopage;
+	min = 1UL << order;
+	for (;;) {
+		zone_t *z = *(zone++);
+		if (!z)
+			break;
+
+		min += z->pages_low;
+		if (z->free_pages > min) {
+			page = buffered_rmqueue(z, order, gfp_mask);
+			if (page)
+				return page;
+		}
+	}
+
+	classzone->need_balance = 1;
+
+rebalance:
+	zone = zonelist->zones;
+	min = 1UL << order;
+	for (;;) {
+		unsigned long local_min;
+		zone_t *z = *(zone++);
+		if (!z)
+			break;
+
+		local_min = z->pages_min;
+		if (!(gfp_mask & __GFP_WAIT))
+			local_min >>= 2;
+		min += local_min;
+		if (z->free_pages > min) {
+			page = buffered_rmqueue(z, order, gfp_mask);
+			if (page)
+				return page;
+		}
+	}
+
+	// 回收空闲的 slab 后再试一次
+	if (!reaped && (gfp_mask & __GFP_WAIT)) {
+		reaped = 1;
+		if (kmem_cache_reap(gfp_mask))
+			goto rebalance;
+	}
+
+	/* here we're in the emergency pools */
+	if (gfp_mask & __GFP_HIGH) {
+		/* pages may be sitting on the per-cpu lists */
+		drain_local_pages();
+		zone = zonelist->zones;
+		for (;;) {
+			zone_t *z = *(zone++);
+			if (!z)
+				break;
+
+			page = buffered_rmqueue(z, order, gfp_mask);
+			if (page)
+				return page;
+		}
+	}
+
+nopage:
+	// 走表期间 zonelist 被重建过，看到的可能是半张表，重来一次
+	if (read_seqcount_retry(&zonelist_seq, seq))
+		goto restart;
+	if (classzone == NULL)
+		return NULL;
+	printk(KERN_NOTICE "__alloc_pages: %u-order allocation failed (gfp=0x%x)\n",
+	       order, gfp_mask);
+	return NULL;
+}
+
+/*
+ * Common helper functions.
+ */
+unsigned long __get_free_pages(unsigned int gfp_mask, unsigned int order)
+{
+	struct page * page;
+
+	page = alloc_pages(gfp_mask, order);
+	if (!page)
+		return 0;
+	return (unsigned long) page_address(page);
+}
+
+unsigned long get_zeroed_page(unsigned int gfp_mask)
+{
+	struct page * page;
+
+	page = alloc_pages(gfp_mask | __GFP_ZERO, 0);
+	if (page)
+		return (unsigned long) page_address(page);
+	return 0;
+}
+
+void __free_pages(struct page *page, unsigned int order)
+{
+	if (!PageReserved(page) && put_page_testzero(page)) {
+		if (order == 0)
+			free_hot_page(page);
+		else
+			__free_pages_ok(page, order);
+	}
+}
+
+void free_pages(unsigned long addr, unsigned int order)
+{
+	if (addr != 0)
+		__free_pages(virt_to_page(addr), order);
+}
+
+/*
+ * Total amount of free (allocatable) RAM:
+ */
+unsigned int nr_free_pages (void)
+{
+	unsigned int sum = 0;
+	zone_t *zone;
+	pg_data_t *pgdat;
+
+	for (pgdat = pgdat_list; pgdat; pgdat = pgdat->node_next)
+		for (zone = pgdat->node_zones; zone < pgdat->node_zones + MAX_NR_ZONES; zone++)
+			sum += zone->free_pages;
+
+	return sum;
+}
+
+/*
+ * Print the number of free blocks of every order in every zone.
+ */
+void show_free_areas(void)
+{
+	pg_data_t *pgdat;
+	unsigned int order, cpu;
+
+	printk("Free pages:      %6dkB\n", nr_free_pages() << (PAGE_SHIFT-10));
+
+	for (pgdat = pgdat_list; pgdat; pgdat = pgdat->node_next) {
+		zone_t *zone;
+
+		for (zone = pgdat->node_zones; zone < pgdat->node_zones + MAX_NR_ZONES; zone++) {
+			unsigned long total = 0, flags;
+
+			if (!zone->size)
+				continue;
+			printk("%s per-cpu:", zone->name);
+			for (cpu = 0; cpu < NR_CPUS; cpu++) {
+				struct per_cpu_pageset *pset = &zone->pageset[cpu];
+
+				printk(" cpu %u hot: low %d, high %d, batch %d, count %d"
+				       " cold: low %d, high %d, batch %d, count %d",
+				       cpu,
+				       pset->pcp[0].low, pset->pcp[0].high,
+				       pset->pcp[0].batch, pset->pcp[0].count,
+				       pset->pcp[1].low, pset->pcp[1].high,
+				       pset->pcp[1].batch, pset->pcp[1].count);
+			}
+			printk("\n%s: ", zone->name);
+			spin_lock_irqsave(&zone->lock, flags);
+			for (order = 0; order < MAX_ORDER; order++) {
+				unsigned long nr = 0;
+				struct list_head *head, *curr;
+
+				head = &zone->free_area[order].free_list;
+				for (curr = head->next; curr != head; curr = curr->next)
+					nr++;
+				total += nr * (1UL << order);
+				printk("%lu*%lukB ", nr, (PAGE_SIZE>>10) << order);
+			}
+			spin_unlock_irqrestore(&zone->lock, flags);
+			printk("= %lukB, zeroed %lukB\n", total * (PAGE_SIZE>>10),
+			       zone->nr_zero_pages * (PAGE_SIZE>>10));
+		}
+	}
+}
+
+/*
+ * Builds allocation fallback zone lists.
+ */
+static inline void build_zonelists(pg_data_t *pgdat)
+{
+	int i, j, k;
+
+	write_seqcount_begin(&zonelist_seq);
+	for (i = 0; i <= GFP_ZONEMASK; i++) {
+		zonelist_t *zonelist;
+		zone_t *zone;
+
+		zonelist = pgdat->node_zonelists + i;
+		memset(zonelist, 0, sizeof(*zonelist));
+
+		j = 0;
+		k = ZONE_NORMAL;
+		if (i & __GFP_HIGHMEM)
+			k = ZONE_HIGHMEM;
+		if (i & __GFP_DMA)
+			k = ZONE_DMA;
+
+		switch (k) {
+			default:
+				BUG();
+			/*
+			 * fallthrough:
+			 */
+			case ZONE_HIGHMEM:
+				zone = pgdat->node_zones + ZONE_HIGHMEM;
+				if (zone->size) {
+#ifndef CONFIG_HIGHMEM
+					BUG();
+#endif
+					zonelist->zones[j++] = zone;
+				}
+			case ZONE_NORMAL:
+				zone = pgdat->node_zones + ZONE_NORMAL;
+				if (zone->size)
+					zonelist->zones[j++] = zone;
+			case ZONE_DMA:
+				zone = pgdat->node_zones + ZONE_DMA;
+				if (zone->size)
+					zonelist->zones[j++] = zone;
+		}
+		zonelist->zones[j++] = NULL;
+	} 
+	write_seqcount_end(&zonelist_seq);
+}
+
+/*
+ * Hand the pages [idx, end_idx) of @zone (indices relative to
+ * zone_start_mapnr) straight to the free lists, as naturally aligned
+ * blocks of up to 2^(MAX_ORDER-1) pages.
+ *
+ * The blocks are never merged with anything: a block only gets a
+ * smaller order than its alignment allows when the range ends, and
+ * the range is a maximal free run, so no buddy of a block can be
+ * free too. Each block therefore just flips its buddy bit once,
+ * exactly what freeing it into an allocated neighbourhood would do.
+ */
+static unsigned long __init free_pages_bootmem_zone(zone_t *zone,
+	unsigned long idx, unsigned long end_idx)
+{
+	unsigned long count = 0, i;
+
+	while (idx < end_idx) {
+		unsigned long order = MAX_ORDER - 1;
+		struct page *page = pfn_to_page(zone->zone_start_mapnr + idx);
+
+		// 找出从 idx 开始、自然对齐且不越过 end_idx 的最大块
+		while ((idx & ((1UL << order) - 1)) || idx + (1UL << order) > end_idx)
+			order--;
+
+		for (i = 0; i < (1UL << order); i++)
+			ClearPageReserved(page + i);
+		page->private = order;
+		list_add_tail(&page->list, &zone->free_area[order].free_list);
+		if (order != MAX_ORDER - 1)
+			__change_bit(idx >> (1 + order), zone->free_area[order].map);
+		zone->free_pages += 1UL << order;
+
+		idx += 1UL << order;
+		count += 1UL << order;
+	}
+	return count;
+}
+
+/*
+ * Release the pages [start_pfn, end_pfn), which the boot allocator
+ * found free, to the buddy allocator. The range is split where it
+ * crosses a zone boundary. Returns the number of pages released.
+ *
+ * Only called from free_all_bootmem(), before anything else can
+ * touch the zones, so no locking.
+ */
+unsigned long __init free_pages_bootmem(unsigned long start_pfn,
+	unsigned long end_pfn)
+{
+	unsigned long count = 0;
+
+	if (end_pfn > max_mapnr)
+		end_pfn = max_mapnr;
+	while (start_pfn < end_pfn) {
+		zone_t *zone = page_zone(pfn_to_page(start_pfn));
+		unsigned long zone_pfn = zone->zone_start_mapnr;
+		unsigned long end = zone_pfn + zone->size;
+
+		if (end > end_pfn)
+			end = end_pfn;
+		count += free_pages_bootmem_zone(zone, start_pfn - zone_pfn,
+						 end - zone_pfn);
+		start_pfn = end;
+	}
+	return count;
+}
+
+#define LONG_ALIGN(x) (((x)+(sizeof(long))-1)&~((sizeof(long))-1))
+
+/*
+ * Set up the zone data structures:
+ *   - mark all pages reserved
+ *   - mark all memory queues empty
+ *   - clear the memory bitmaps
+ */
+void __init free_area_init_core(int nid, pg_data_t *pgdat, struct page **gmap,
+	unsigned long *zones_size, unsigned long zone_start_paddr, 
+	unsigned long *zholes_size, struct page *lmem_map)
+{
+	unsigned long i, j;
+#ifndef CONFIG_SPARSEMEM
+	unsigned long map_size;
+#endif
+	unsigned long totalpages, offset, realtotalpages;
+	const unsigned long zone_required_alignment = 1UL << (MAX_ORDER-1);
+
+	BUILD_BUG_ON(sizeof(struct page) > 32);
+	BUILD_BUG_ON(MAX_NR_ZONES > (1 << ZONES_SHIFT));
+	BUILD_BUG_ON(PG_reserved >= ZONETABLE_PGSHIFT);
+
+	if (zone_start_paddr & ~PAGE_MASK)
+		BUG();
+	if (nid >= MAX_NUMNODES)
+		BUG();
+
+	totalpages = 0;
+	for (i = 0; i < MAX_NR_ZONES; i++) {
+		unsigned long size = zones_size[i];
+		totalpages += size;
+	}
+	realtotalpages = totalpages;
+	if (zholes_size)
+		for (i = 0; i < MAX_NR_ZONES; i++)
+			realtotalpages -= zholes_size[i];
+
+#ifndef CONFIG_SPARSEMEM
+	/*
+	 * Some architectures (with lots of mem and discontinous memory
+	 * maps) have to search for a good mem_map area. The node's map
+	 * covers exactly the page frames spanned by its zones, and comes
+	 * cache line aligned from the node's own memory.
+	 */
+	map_size = totalpages*sizeof(struct page);
+	if (lmem_map == (struct page *)0)
+		lmem_map = (struct page *) alloc_bootmem_node(pgdat, map_size);
+	*gmap = pgdat->node_mem_map = lmem_map;
+	offset = lmem_map - mem_map;	
+	printk("On node %d totalpages: %lu, mem_map %luk (%u bytes/page)\n",
+		nid, realtotalpages, map_size >> 10, sizeof(struct page));
+#else
+	/*
+	 * mem_map was allocated section by section in sparse_init(),
+	 * a page is only found through pfn_to_page().
+	 */
+	pgdat->node_mem_map = NULL;
+	offset = zone_start_paddr >> PAGE_SHIFT;
+	printk("On node %d totalpages: %lu (%u bytes/page)\n",
+		nid, realtotalpages, sizeof(struct page));
+#endif
+
+	pgdat->node_size = totalpages;
+	pgdat->node_start_paddr = zone_start_paddr;
+	pgdat->node_start_mapnr = offset;
+	pgdat->nr_zones = 0;
+
+	for (j = 0; j < MAX_NR_ZONES; j++) {
+		zone_t *zone = pgdat->node_zones + j;
+		unsigned long mask, batch;
+		unsigned long size, realsize;
+		int cpu;
+
+		realsize = size = zones_size[j];
+		if (zholes_size)
+			realsize -= zholes_size[j];
+
+		zone->size = size;
+		zone->name = zone_names[j];
+		zone->lock = QSPIN_LOCK_UNLOCKED;
+		zone->zone_pgdat = pgdat;
+		zone->free_pages = 0;
+		zone->need_balance = 0;
+		INIT_LIST_HEAD(&zone->zero_list);
+		zone->nr_zero_pages = 0;
+		zone->zero_pages_high = 0;
+		zone_table[NODEZONE(nid, j)] = zone;
+		if (!size)
+			continue;
+
+		pgdat->nr_zones = j+1;
+
+		/*
+		 * The per-cpu-pages pools are set to around 1/1000th of the
+		 * zone, at most 256KB per batch.
+		 */
+		batch = realsize / 1024;
+		if (batch * PAGE_SIZE > 256 * 1024)
+			batch = (256 * 1024) / PAGE_SIZE;
+		batch /= 4;		/* We effectively *= 4 below */
+		if (batch < 1)
+			batch = 1;
+
+		for (cpu = 0; cpu < NR_CPUS; cpu++) {
+			struct per_cpu_pages *pcp;
+
+			pcp = &zone->pageset[cpu].pcp[0];	/* hot */
+			pcp->count = 0;
+			pcp->low = 2 * batch;
+			pcp->high = 6 * batch;
+			pcp->batch = 1 * batch;
+			INIT_LIST_HEAD(&pcp->list);
+
+			pcp = &zone->pageset[cpu].pcp[1];	/* cold */
+			pcp->count = 0;
+			pcp->low = 0;
+			pcp->high = 2 * batch;
+			pcp->batch = 1 * batch;
+			INIT_LIST_HEAD(&pcp->list);
+		}
+		printk("  %s zone: %lu pages, LIFO batch:%lu\n",
+				zone_names[j], realsize, batch);
+
+		mask = (realsize / zone_balance_ratio[j]);
+		if (mask < zone_balance_min[j])
+			mask = zone_balance_min[j];
+		else if (mask > zone_balance_max[j])
+			mask = zone_balance_max[j];
+		zone->pages_min = mask;
+		zone->pages_low = mask*2;
+		zone->pages_high = mask*3;
+
+		/*
+		 * The idle loop keeps up to 1/64th of the zone, at most
+		 * 4MB, cleared in advance. ZONE_DMA is too small to spare.
+		 */
+		if (j != ZONE_DMA) {
+			zone->zero_pages_high = realsize / 64;
+			if (zone->zero_pages_high > (4 * 1024 * 1024) / PAGE_SIZE)
+				zone->zero_pages_high = (4 * 1024 * 1024) / PAGE_SIZE;
+		}
+
+		zone->zone_mem_map = early_pfn_valid(offset) ? pfn_to_page(offset) : NULL;
+		zone->zone_start_mapnr = offset;
+		zone->zone_start_paddr = zone_start_paddr;
+
+		if ((zone_start_paddr >> PAGE_SHIFT) & (zone_required_alignment-1))
+			printk("BUG: wrong zone alignment, it will crash\n");
+
+		/*
+		 * Initially all pages are reserved - free ones are freed
+		 * up by free_all_bootmem() once the early boot process is
+		 * done. Non-atomic initialization, single-pass.
+		 * Page frames in sections without RAM have no struct page.
+		 */
+		for (i = 0; i < size; i++) {
+			struct page *page;
+
+			if (!early_pfn_valid(offset + i)) {
+				zone_start_paddr += PAGE_SIZE;
+				continue;
+			}
+			page = pfn_to_page(offset + i);
+			page->flags = 1UL << PG_reserved;
+			if (j == ZONE_HIGHMEM)
+				page->flags |= 1UL << PG_highmem;
+			set_page_links(page, j, nid, offset + i);
+			set_page_count(page, 0);
+			INIT_LIST_HEAD(&page->list);
+			zone_start_paddr += PAGE_SIZE;
+		}
+
+		offset += size;
+		for (i = 0; ; i++) {
+			unsigned long bitmap_size;
+
+			INIT_LIST_HEAD(&zone->free_area[i].free_list);
+			if (i == MAX_ORDER-1) {
+				zone->free_area[i].map = NULL;
+				break;
+			}
+
+			/*
+			 * Page buddy system uses "index >> (i+1)",
+			 * where "index" is at most "size-1".
+			 *
+			 * The extra "+3" is to round down to byte
+			 * size (8 bits per byte assumption). Thus
+			 * we get "(size-1) >> (i+4)" as the last byte
+			 * we can access.
+			 *
+			 * The "+1" is because we want to round the
+			 * byte allocation up rather than down. So
+			 * we should have had a "+7" before we shifted
+			 * down by three. Also, we have to add one as
+			 * we actually _use_ the last bit (it's [0,n]
+			 * inclusive, not [0,n[).
+			 *
+			 * So we actually had +7+1 before we shift
+			 * down by 3. But (n+8) >> 3 == (n >> 3) + 1
+			 * (modulo overflows, which we do not have).
+			 *
+			 * Finally, we LONG_ALIGN because all bitmap
+			 * operations are on longs.
+			 */
+			bitmap_size = (size-1) >> (i+4);
+			bitmap_size = LONG_ALIGN(bitmap_size+1);
+			zone->free_area[i].map = 
+			  (unsigned long *) alloc_bootmem_node(pgdat, bitmap_size);
+		}
+	}
+	build_zonelists(pgdat);
+}
 
-pg_data_t *pgdat_list;
\ No newline at end of file
+void __init free_area_init(unsigned long *zones_size)
+{
+	free_area_init_core(0, &contig_page_data, &mem_map, zones_size, 0, 0, 0);
+}
@@ -0,0 +1,88 @@
+/*
+ *  linux/mm/sparse.c
+ *
+ *  sparse memory mappings.
+ *
+ *  Physical memory is handled in sections of PAGES_PER_SECTION page
+ *  frames. Only the sections the firmware reports RAM in get their
+ *  part of mem_map; holes such as the PCI window or large reserved
+ *  ranges cost one mem_section word instead of a run of struct pages.
+ */
+#include <linux/mm.h>
+#include <linux/mmzone.h>
+#include <linux/bootmem.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <asm/stdio.h>
+
+#ifdef CONFIG_SPARSEMEM
+
+/*
+ * Permanent SPARSEMEM data:
+ *
+ * 1) mem_section	- memory sections, mem_map's for valid memory
+ */
+struct mem_section mem_section[NR_MEM_SECTIONS];
+
+/* Record a memory area against a node. */
+void __init memory_present(int nid, unsigned long start, unsigned long end)
+{
+	unsigned long pfn;
+
+	start &= PAGE_SECTION_MASK;
+	for (pfn = start; pfn < end; pfn += PAGES_PER_SECTION) {
+		unsigned long section = pfn_to_section_nr(pfn);
+
+		if (section >= NR_MEM_SECTIONS)
+			break;
+		mem_section[section].section_mem_map |= SECTION_MARKED_PRESENT;
+	}
+}
+
+/*
+ * Subtle, we encode the real pfn into the mem_map such that
+ * the identity pfn - section_mem_map will return the actual
+ * physical page frame number.
+ */
+static unsigned long sparse_encode_mem_map(struct page *mem_map, unsigned long pnum)
+{
+	return (unsigned long)(mem_map - (section_nr_to_pfn(pnum)));
+}
+
+static int sparse_init_one_section(struct mem_section *ms,
+		unsigned long pnum, struct page *mem_map)
+{
+	if (!valid_section(ms))
+		return -1;
+
+	ms->section_mem_map &= ~SECTION_MAP_MASK;
+	ms->section_mem_map |= sparse_encode_mem_map(mem_map, pnum) |
+							SECTION_HAS_MEM_MAP;
+
+	return 1;
+}
+
+/*
+ * Allocate the accumulated non-linear sections, allocate a mem_map
+ * for each and record the physical to section mapping.
+ */
+void __init sparse_init(void)
+{
+	unsigned long pnum, present = 0;
+	struct page *map;
+
+	for (pnum = 0; pnum < NR_MEM_SECTIONS; pnum++) {
+		if (!valid_section(__nr_to_section(pnum)))
+			continue;
+
+		map = alloc_bootmem_node(&contig_page_data,
+				sizeof(struct page) * PAGES_PER_SECTION);
+		sparse_init_one_section(__nr_to_section(pnum), pnum, map);
+		present++;
+	}
+	printk("sparse: %lu of %lu sections present, mem_map %luk\n",
+		present, NR_MEM_SECTIONS,
+		(present * PAGES_PER_SECTION * sizeof(struct page)) >> 10);
+}
+
+#endif /* CONFIG_SPARSEMEM */
@@ -0,0 +1,532 @@
+/*
+ *  linux/mm/vmalloc.c
+ *
+ *  Copyright (C) 1993  Linus Torvalds
+ *  Support of BIGMEM added by Gerhard Wichert, Siemens AG, July 1999
+ *  SMP-safe vmalloc/vfree/ioremap, Tigran Aivazian <tigran@veritas.com>, May 2000
+ *
+ *  The vmalloc window [VMALLOC_START, VMALLOC_END) is handed out by
+ *  two address-ordered red-black trees of vmap_areas:
+ *
+ *  - the busy tree holds the mapped areas and finds the area for
+ *    vfree()/iounmap();
+ *  - the free tree holds the unused ranges. Each node also records the
+ *    size of the largest free range in its subtree, so the lowest
+ *    range that fits a request is found in O(log n) without walking
+ *    the ranges that are too small. Freed ranges are merged with their
+ *    neighbours, which are found through the address-sorted list.
+ *
+ *  Unmapping is lazy: the page tables of a freed area are cleared at
+ *  once, but the range is only given back to the free tree, and the
+ *  TLB only flushed, when lazy_max_pages() worth of areas have piled
+ *  up or an allocation runs out of space. Until then nobody can map
+ *  the range again, so the stale TLB entries are harmless, and one
+ *  flush covers many vfree()s.
+ */
+
+#include <linux/vmalloc.h>
+#include <linux/slab.h>
+#include <linux/rbtree.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/debug.h>
+#include <linux/string.h>
+#include <linux/spinlock.h>
+#include <asm/stdio.h>
+
+struct vmap_area {
+	unsigned long va_start;
+	unsigned long va_end;
+	unsigned long subtree_max_size;	/* free tree: largest range below */
+	rb_node_t rb_node;		/* address sorted rbtree */
+	struct list_head list;		/* address sorted list, or purge list */
+	struct vm_struct *vm;
+};
+
+static spinlock_t vmap_area_lock = SPIN_LOCK_UNLOCKED;
+
+static rb_root_t vmap_area_root = RB_ROOT;		// 已分配的区域
+static rb_root_t free_vmap_area_root = RB_ROOT;		// 空闲的区域
+static LIST_HEAD(free_vmap_area_list);
+static LIST_HEAD(vmap_purge_list);			// 等待刷新 TLB 的区域
+static unsigned long vmap_lazy_nr;
+
+static kmem_cache_t *vmap_area_cachep;
+
+#define va_size(va)	((va)->va_end - (va)->va_start)
+
+/*
+ * Clear the ptes of [addr, addr+size). The page tables themselves are
+ * kept: the kernel has a single page directory, so there is nothing
+ * to keep in sync, and the next mapping of the range reuses them.
+ */
+static void vunmap_page_range(unsigned long addr, unsigned long end)
+{
+	pmd_t *pmd;
+	pte_t *pte;
+
+	while (addr < end) {
+		// paging_init() 为内核空间建好了全部页中间目录
+		pmd = pmd_offset(pgd_offset_k(addr), addr);
+		if (pmd_none(*pmd)) {
+			addr = (addr + PMD_SIZE) & PMD_MASK;
+			continue;
+		}
+		pte = pte_offset(pmd, addr);
+		do {
+			pte_clear(pte);
+			pte++;
+			addr += PAGE_SIZE;
+		} while (addr < end && (addr & ~PMD_MASK));
+	}
+}
+
+pte_t *pte_alloc_kernel(pmd_t *pmd, unsigned long address)
+{
+	if (pmd_none(*pmd)) {
+		unsigned long page = get_zeroed_page(GFP_KERNEL);
+
+		if (!page)
+			return NULL;
+		set_pmd(pmd, __pmd(__pa(page) | PAGE_PRESENT | PAGE_WRITE));
+	}
+	return pte_offset(pmd, address);
+}
+
+int map_vm_area(struct vm_struct *area, pgprot_t prot, struct page **pages)
+{
+	unsigned long addr = (unsigned long) area->addr;
+	unsigned long end = addr + area->size - PAGE_SIZE;
+	pte_t *pte = NULL;
+
+	for (; addr < end; addr += PAGE_SIZE) {
+		if (!pte || !(addr & ~PMD_MASK)) {
+			pte = pte_alloc_kernel(pmd_offset(pgd_offset_k(addr), addr), addr);
+			if (!pte)
+				return -1;
+		}
+		if (!pte_none(*pte))
+			printk(KERN_ERR "map_vm_area: page already exists\n");
+		set_pte(pte, mk_pte(*pages, prot));
+		pages++;
+		pte++;
+	}
+	return 0;
+}
+
+/*
+ * The ptes are gone right away, the TLB entries only at the next
+ * lazy purge.
+ */
+void unmap_kernel_range(unsigned long addr, unsigned long size)
+{
+	vunmap_page_range(addr, addr + size);
+}
+
+static struct vmap_area *__find_vmap_area(unsigned long addr)
+{
+	rb_node_t *n = vmap_area_root.rb_node;
+
+	while (n) {
+		struct vmap_area *va;
+
+		va = rb_entry(n, struct vmap_area, rb_node);
+		if (addr < va->va_start)
+			n = n->rb_left;
+		else if (addr > va->va_start)
+			n = n->rb_right;
+		else
+			return va;
+	}
+
+	return NULL;
+}
+
+static void __insert_vmap_area(struct vmap_area *va)
+{
+	rb_node_t **p = &vmap_area_root.rb_node;
+	rb_node_t *parent = NULL;
+
+	while (*p) {
+		struct vmap_area *tmp;
+
+		parent = *p;
+		tmp = rb_entry(parent, struct vmap_area, rb_node);
+		if (va->va_end <= tmp->va_start)
+			p = &(*p)->rb_left;
+		else if (va->va_start >= tmp->va_end)
+			p = &(*p)->rb_right;
+		else
+			BUG();
+	}
+
+	rb_link_node(&va->rb_node, parent, p);
+	rb_insert_color(&va->rb_node, &vmap_area_root);
+}
+
+/* Free tree */
+
+static inline unsigned long get_subtree_max_size(rb_node_t *node)
+{
+	return node ? rb_entry(node, struct vmap_area, rb_node)->subtree_max_size : 0;
+}
+
+static void augment_vmap_area(rb_node_t *node, void *unused)
+{
+	struct vmap_area *va = rb_entry(node, struct vmap_area, rb_node);
+	unsigned long max = va_size(va);
+
+	if (get_subtree_max_size(node->rb_left) > max)
+		max = get_subtree_max_size(node->rb_left);
+	if (get_subtree_max_size(node->rb_right) > max)
+		max = get_subtree_max_size(node->rb_right);
+	va->subtree_max_size = max;
+}
+
+/* A free range changed size in place: fix the maxima up to the root. */
+static void augment_vmap_area_path(struct vmap_area *va)
+{
+	rb_node_t *node = &va->rb_node;
+
+	while (node) {
+		augment_vmap_area(node, NULL);
+		node = node->rb_parent;
+	}
+}
+
+static void unlink_free_vmap_area(struct vmap_area *va)
+{
+	rb_node_t *deepest = rb_augment_erase_begin(&va->rb_node);
+
+	rb_erase(&va->rb_node, &free_vmap_area_root);
+	rb_augment_erase_end(deepest, augment_vmap_area, NULL);
+	list_del(&va->list);
+}
+
+/*
+ * Give [va_start, va_end) back to the free tree, merging it with the
+ * free ranges right before and after it. @va is freed if it is merged.
+ */
+static void merge_or_add_vmap_area(struct vmap_area *va)
+{
+	rb_node_t **p = &free_vmap_area_root.rb_node;
+	rb_node_t *parent = NULL;
+	struct list_head *next;
+	struct vmap_area *sibling;
+
+	while (*p) {
+		struct vmap_area *tmp;
+
+		parent = *p;
+		tmp = rb_entry(parent, struct vmap_area, rb_node);
+		if (va->va_end <= tmp->va_start)
+			p = &(*p)->rb_left;
+		else if (va->va_start >= tmp->va_end)
+			p = &(*p)->rb_right;
+		else
+			BUG();	// 与空闲区域重叠，重复释放
+	}
+
+	// 在有序链表中找到插入位置之后的区域
+	if (!parent)
+		next = &free_vmap_area_list;
+	else if (p == &parent->rb_left)
+		next = &rb_entry(parent, struct vmap_area, rb_node)->list;
+	else
+		next = rb_entry(parent, struct vmap_area, rb_node)->list.next;
+
+	if (next != &free_vmap_area_list) {
+		sibling = list_entry(next, struct vmap_area, list);
+		if (sibling->va_start == va->va_end) {
+			sibling->va_start = va->va_start;
+			kmem_cache_free(vmap_area_cachep, va);
+			va = sibling;
+			goto merge_prev;
+		}
+	}
+
+	if (next->prev != &free_vmap_area_list) {
+		sibling = list_entry(next->prev, struct vmap_area, list);
+		if (sibling->va_end == va->va_start) {
+			sibling->va_end = va->va_end;
+			kmem_cache_free(vmap_area_cachep, va);
+			augment_vmap_area_path(sibling);
+			return;
+		}
+	}
+
+	va->subtree_max_size = va_size(va);
+	rb_link_node(&va->rb_node, parent, p);
+	rb_insert_color(&va->rb_node, &free_vmap_area_root);
+	rb_augment_insert(&va->rb_node, augment_vmap_area, NULL);
+	list_add_tail(&va->list, next);
+	return;
+
+merge_prev:
+	// 已与后一个区域合并，再看能否与前一个区域合并
+	if (va->list.prev != &free_vmap_area_list) {
+		sibling = list_entry(va->list.prev, struct vmap_area, list);
+		if (sibling->va_end == va->va_start) {
+			sibling->va_end = va->va_end;
+			unlink_free_vmap_area(va);
+			kmem_cache_free(vmap_area_cachep, va);
+			augment_vmap_area_path(sibling);
+			return;
+		}
+	}
+	augment_vmap_area_path(va);
+}
+
+/*
+ * Lowest free range that can hold @size bytes: go left whenever the
+ * left subtree has a big enough range, else take this node if it
+ * fits, else go right.
+ */
+static struct vmap_area *find_vmap_lowest_match(unsigned long size)
+{
+	rb_node_t *node = free_vmap_area_root.rb_node;
+
+	while (node) {
+		struct vmap_area *va = rb_entry(node, struct vmap_area, rb_node);
+
+		if (get_subtree_max_size(node->rb_left) >= size)
+			node = node->rb_left;
+		else if (va_size(va) >= size)
+			return va;
+		else if (get_subtree_max_size(node->rb_right) >= size)
+			node = node->rb_right;
+		else
+			break;
+	}
+	return NULL;
+}
+
+/*
+ * Lazy purging: 32MB worth of freed areas are kept unusable before
+ * their TLB entries are flushed in one go.
+ */
+static unsigned long lazy_max_pages(void)
+{
+	return 32UL * 1024 * 1024 / PAGE_SIZE;
+}
+
+/*
+ * Called with vmap_area_lock held, taken with spin_lock_irqsave(*flags).
+ * The lock is dropped around the TLB flush: the other CPUs take an IPI
+ * for it, and one of them may be spinning on the lock with interrupts
+ * off. The purged areas are on no list meanwhile, so nobody can hand
+ * them out before they are merged back.
+ */
+static int __purge_vmap_area_lazy(unsigned long *flags)
+{
+	unsigned long start = ~0UL, end = 0;
+	struct list_head *p;
+	LIST_HEAD(purge);
+
+	if (list_empty(&vmap_purge_list))
+		return 0;
+
+	list_splice_init(&vmap_purge_list, &purge);
+	vmap_lazy_nr = 0;
+	list_for_each(p, &purge) {
+		struct vmap_area *va = list_entry(p, struct vmap_area, list);
+
+		if (va->va_start < start)
+			start = va->va_start;
+		if (va->va_end > end)
+			end = va->va_end;
+	}
+	spin_unlock_irqrestore(&vmap_area_lock, *flags);
+	flush_tlb_kernel_range(start, end);
+	spin_lock_irqsave(&vmap_area_lock, *flags);
+
+	while (!list_empty(&purge)) {
+		struct vmap_area *va;
+
+		va = list_entry(purge.next, struct vmap_area, list);
+		list_del(&va->list);
+		merge_or_add_vmap_area(va);
+	}
+	return 1;
+}
+
+/*
+ * Allocate a region of KVA of the specified size. Sizes are multiples
+ * of PAGE_SIZE, so the lowest range that fits is always used from its
+ * start.
+ */
+static struct vmap_area *alloc_vmap_area(unsigned long size)
+{
+	struct vmap_area *va, *free;
+	unsigned long flags;
+
+	va = kmem_cache_alloc(vmap_area_cachep, GFP_KERNEL);
+	if (!va)
+		return NULL;
+
+	spin_lock_irqsave(&vmap_area_lock, flags);
+	free = find_vmap_lowest_match(size);
+	if (!free && __purge_vmap_area_lazy(&flags))
+		free = find_vmap_lowest_match(size);
+	if (!free) {
+		spin_unlock_irqrestore(&vmap_area_lock, flags);
+		kmem_cache_free(vmap_area_cachep, va);
+		printk(KERN_WARNING "vmap allocation for size %lu failed\n", size);
+		return NULL;
+	}
+
+	va->va_start = free->va_start;
+	va->va_end = va->va_start + size;
+	va->vm = NULL;
+	if (va_size(free) == size) {
+		unlink_free_vmap_area(free);
+		kmem_cache_free(vmap_area_cachep, free);
+	} else {
+		free->va_start += size;
+		augment_vmap_area_path(free);
+	}
+	__insert_vmap_area(va);
+	spin_unlock_irqrestore(&vmap_area_lock, flags);
+
+	return va;
+}
+
+struct vm_struct * get_vm_area(unsigned long size, unsigned long flags)
+{
+	struct vm_struct *area;
+	struct vmap_area *va;
+
+	size = PAGE_ALIGN(size);
+	if (!size)
+		return NULL;
+
+	area = (struct vm_struct *) kmalloc(sizeof(*area), GFP_KERNEL);
+	if (!area)
+		return NULL;
+	memset(area, 0, sizeof(*area));
+
+	/*
+	 * We always allocate a guard page.
+	 */
+	size += PAGE_SIZE;
+	va = alloc_vmap_area(size);
+	if (!va) {
+		kfree(area);
+		return NULL;
+	}
+
+	area->flags = flags;
+	area->addr = (void *)va->va_start;
+	area->size = size;
+	va->vm = area;
+	return area;
+}
+
+/**
+ * remove_vm_area - find and remove a contiguous kernel virtual area
+ * @addr: base address
+ *
+ * Clears the mapping and returns the vm_struct for the caller to free;
+ * the address range itself is given back lazily.
+ */
+struct vm_struct * remove_vm_area(void * addr)
+{
+	struct vmap_area *va;
+	struct vm_struct *vm;
+	unsigned long flags;
+
+	spin_lock_irqsave(&vmap_area_lock, flags);
+	va = __find_vmap_area((unsigned long)addr);
+	if (!va || !va->vm) {
+		spin_unlock_irqrestore(&vmap_area_lock, flags);
+		return NULL;
+	}
+	vm = va->vm;
+	va->vm = NULL;
+	rb_erase(&va->rb_node, &vmap_area_root);
+
+	vunmap_page_range(va->va_start, va->va_end);
+
+	list_add_tail(&va->list, &vmap_purge_list);
+	vmap_lazy_nr += va_size(va) >> PAGE_SHIFT;
+	if (vmap_lazy_nr > lazy_max_pages())
+		__purge_vmap_area_lazy(&flags);
+	spin_unlock_irqrestore(&vmap_area_lock, flags);
+
+	return vm;
+}
+
+void vfree(void * addr)
+{
+	struct vm_struct *area;
+	unsigned int i;
+
+	if (!addr)
+		return;
+	if ((PAGE_SIZE-1) & (unsigned long) addr) {
+		printk(KERN_ERR "Trying to vfree() bad address (%p)\n", addr);
+		return;
+	}
+	area = remove_vm_area(addr);
+	if (!area) {
+		printk(KERN_ERR "Trying to vfree() nonexistent vm area (%p)\n", addr);
+		return;
+	}
+	for (i = 0; i < area->nr_pages; i++)
+		__free_page(area->pages[i]);
+	kfree(area->pages);
+	kfree(area);
+}
+
+void * __vmalloc (unsigned long size, int gfp_mask, pgprot_t prot)
+{
+	struct vm_struct *area;
+	unsigned int nr_pages, i;
+
+	size = PAGE_ALIGN(size);
+	if (!size || (size >> PAGE_SHIFT) > num_physpages)
+		return NULL;
+	area = get_vm_area(size, VM_ALLOC);
+	if (!area)
+		return NULL;
+
+	nr_pages = size >> PAGE_SHIFT;
+	area->pages = kmalloc(nr_pages * sizeof(struct page *), GFP_KERNEL);
+	if (!area->pages) {
+		remove_vm_area(area->addr);
+		kfree(area);
+		return NULL;
+	}
+	for (i = 0; i < nr_pages; i++) {
+		area->pages[i] = alloc_page(gfp_mask);
+		if (!area->pages[i])
+			goto fail;
+		area->nr_pages++;
+	}
+	if (map_vm_area(area, prot, area->pages))
+		goto fail;
+	return area->addr;
+
+fail:
+	vfree(area->addr);
+	return NULL;
+}
+
+void __init vmalloc_init(void)
+{
+	struct vmap_area *va;
+
+	vmap_area_cachep = kmem_cache_create("vmap_area",
+			sizeof(struct vmap_area), 0, 0, NULL, NULL);
+	if (!vmap_area_cachep)
+		BUG();
+
+	va = kmem_cache_alloc(vmap_area_cachep, GFP_KERNEL);
+	va->va_start = VMALLOC_START;
+	va->va_end = VMALLOC_END;
+	va->vm = NULL;
+	merge_or_add_vmap_area(va);
+
+	printk("vmalloc: 0x%08lx - 0x%08lx (%luMB)\n", VMALLOC_START,
+		VMALLOC_END, (VMALLOC_END - VMALLOC_START) >> 20);
+}